@@ -2,6 +2,10 @@
 // Licensed under the MIT license.
 
 #include "examples.h"
+#include "ckks_constant_cache.h"
+#include "ckks_scale_manager.h"
+#include "ckks_partial_decoder.h"
+#include "ckks_poly_evaluator.h"
 
 using namespace std;
 using namespace seal;
@@ -55,8 +59,31 @@ void example_ckks_task()
     keygen.create_public_key(public_key);
     RelinKeys relin_keys;
     keygen.create_relin_keys(relin_keys);
+
+    /*
+    The rotations the pipeline below applies to the result, in order. The
+    Galois keys are generated for exactly these steps and the rotation stage
+    walks the same list, so adding a rotation here is all it takes. See
+    ckks_galois_key_benchmark.cpp for the comparison with the key set that
+    create_galois_keys() makes by default (every power-of-two step).
+    파이프라인이 실제로 하는 rotation 만 Galois key 로 만든다.
+    */
+    const vector<int> pipeline_rotations = { 2 };
+    vector<int> rotation_steps(pipeline_rotations);
+    sort(rotation_steps.begin(), rotation_steps.end());
+    rotation_steps.erase(unique(rotation_steps.begin(), rotation_steps.end()), rotation_steps.end());
+
     GaloisKeys gal_keys;
-    keygen.create_galois_keys(gal_keys);
+    keygen.create_galois_keys(rotation_steps, gal_keys);
+    print_line(__LINE__);
+    cout << "Galois keys for steps";
+    for (int step : rotation_steps)
+    {
+        cout << " " << step;
+    }
+    cout << ": " << gal_keys.size() << " keys, "
+         << static_cast<double>(gal_keys.save_size(compr_mode_type::none)) / (1 << 20) << " MB" << endl;
+
     Encryptor encryptor(context, public_key);
     Evaluator evaluator(context);
     Decryptor decryptor(context, secret_key);
@@ -84,10 +111,11 @@ void example_ckks_task()
     that encodes the given floating-point value to every slot in the vector.
     scale(2^50) 값을 이용해 2와 1을 encode. 
     ex 3.14 * 1000(scale) = 3140 소수는 다루기 어려움. 정수로 바꾸는 작업
+
+    The constants come from a CKKSConstantCache, which encodes them directly
+    at the level and scale of the ciphertext they are added to, once.
     */
-    Plaintext plain_coeff2, plain_coeff1;
-    encoder.encode(2, scale, plain_coeff2);
-    encoder.encode(1, scale, plain_coeff1);
+    CKKSConstantCache constants(encoder);
 
     //x
     Plaintext x_plain;
@@ -96,6 +124,7 @@ void example_ckks_task()
     encoder.encode(input, scale, x_plain);
     Ciphertext x1_encrypted;
     encryptor.encrypt(x_plain, x1_encrypted);
+    const Plaintext &plain_coeff1 = constants.get_for(1, x1_encrypted);
 
     /*
     we first compute x^2 and relinearize. However, the scale has now grown to 2^100.
@@ -121,16 +150,19 @@ void example_ckks_task()
     evaluator.rescale_to_next_inplace(x2_encrypted);
     cout << "    + Scale of x^2 after rescale: " << log2(x2_encrypted.scale()) << " bits" << endl;
 
-    x2_encrypted.scale() = pow(2.0, 50);
+    /*
+    The scale of x^2 is not forced back to 2^50 here: 2 is encoded at its exact
+    scale below, and (x+1)^2 is rescaled by the same prime, so it ends up with
+    exactly the same scale.
+    */
 
     /*
     x^2: level 3
-    2  : level 4  -> level 3 (lowest level로 맞춰주는 작업)
+    2  : level 3 에서 바로 encode (mod_switch_to_inplace 불필요)
         */
     print_line(__LINE__);
-    cout << "Normalize encryption parameters to the lowest level." << endl;
-    parms_id_type last_parms_id = x2_encrypted.parms_id();
-    evaluator.mod_switch_to_inplace(plain_coeff2, last_parms_id);
+    cout << "Encode 2 at the level and scale of x^2." << endl;
+    const Plaintext &plain_coeff2 = constants.get_for(2, x2_encrypted);
     
     /*
     (x^2 + 1)
@@ -144,18 +176,19 @@ void example_ckks_task()
 
 
     /*
-    x^2+1
-    Now we would hope to compute the sum of two terms(x^2 and 1). However, there is
-    a serious problem: the encryption parameters used by all three terms are
-    different due to modulus switching from rescaling.
-
     Encrypted addition and subtraction require that the scales of the inputs are
     the same, and also that the encryption parameters (parms_id) match. If there
     is a mismatch, Evaluator will throw an exception.
+
+    The terms are at different levels because of rescaling: x is still at the
+    top level, x^2 has been rescaled once. CKKSConstantCache encodes every
+    constant at the level of the term it is added to, so 1 matches x and 2
+    matches x^2 without any mod_switch_to_inplace.
+    상수는 더해질 항의 level 에서 바로 encode 되므로 항과 상수의 parms_id 가 같다.
     */
     cout << endl;
     print_line(__LINE__);
-    cout << "Parameters used by all three terms are different." << endl;
+    cout << "Each constant is at the level of the term it is added to." << endl;
     cout << "    + Modulus chain index for x2_encrypted: "
          << context.get_context_data(x2_encrypted.parms_id())->chain_index() << endl;
     cout << "    + Modulus chain index for x1_encrypted: "
@@ -178,18 +211,18 @@ void example_ckks_task()
         - Product x^2 has scale 2^100 and is at level 3
         - We rescaled down to scale 2^100/P_4
 
-        - To compute (x^2 + 2), 2 must be at level 3. But 2 is now at level 4
-        - Rescale 2 (level 4 -> level 3)
-        - (x^2 + 2)  is at level 3.
+        - 2 is encoded directly at level 3 with the exact scale 2^100/P_4
+        - (x^2 + 2) is at level 3.
 
         - Product (x+1)^2 and (x^2+2) has scale (2^100/P_4)^2
         - We rescaled it down to scale (2^100/P_4)^2/P_3 and level 2;
 
-    Although the scales of all three terms are approximately 2^50, their exact
-    values are different, hence they cannot be added together.
+    The scales of x and x^2 are both approximately 2^50 but not equal. Each
+    constant is encoded at the exact scale of its own term, so both additions
+    go through.
     */
     print_line(__LINE__);
-    cout << "The exact scales of terms are different:" << endl;
+    cout << "Exact scales of the terms and their constants:" << endl;
     ios old_fmt(nullptr);
     old_fmt.copyfmt(cout);
     cout << fixed << setprecision(10);
@@ -265,17 +298,139 @@ void example_ckks_task()
     cout << "    + Computed result ...... Correct." << endl;
     print_vector(result, 3, 7);
 
-    Ciphertext rotated;
-    Plaintext plain;
+    /*
+    A client that only reads a few outputs does not need all slot_count slots.
+    CKKSPartialDecoder computes just those and skips the FFT.
+    앞의 몇 개 slot 만 decode.
+    */
     print_line(__LINE__);
-    cout << "Rotate 2 steps left." << endl;
-    evaluator.rotate_vector(result1_encrypted, 2, gal_keys, rotated);
+    cout << "Decode only the first 4 slots." << endl;
+    CKKSPartialDecoder partial_decoder(context);
+    vector<double> first_slots;
+    chrono::high_resolution_clock::time_point decode_start, decode_end;
+
+    decode_start = chrono::high_resolution_clock::now();
+    encoder.decode(plain_result, result);
+    decode_end = chrono::high_resolution_clock::now();
+    auto time_full_decode = chrono::duration_cast<chrono::microseconds>(decode_end - decode_start);
+
+    decode_start = chrono::high_resolution_clock::now();
+    partial_decoder.decode_first(plain_result, 4, first_slots);
+    decode_end = chrono::high_resolution_clock::now();
+    auto time_partial_decode = chrono::duration_cast<chrono::microseconds>(decode_end - decode_start);
+
+    cout << "    + " << first_slots[0] << ", " << first_slots[1] << ", " << first_slots[2] << ", " << first_slots[3]
+         << endl;
+    cout << "    + full decode: " << time_full_decode.count() << " microseconds, first 4 slots: "
+         << time_partial_decode.count() << " microseconds" << endl;
+
+    Ciphertext rotated = result1_encrypted;
+    Plaintext plain;
+    for (int step : pipeline_rotations)
+    {
+        print_line(__LINE__);
+        cout << "Rotate " << step << " steps left." << endl;
+        evaluator.rotate_vector_inplace(rotated, step, gal_keys);
+    }
     cout << "    + Decrypt and decode ...... Correct." << endl;
     decryptor.decrypt(rotated, plain);
     vector<double> result2;
     encoder.decode(plain, result2);
     print_vector(result2, 3, 7);
 
+    /*
+    Every further evaluation of the polynomial needs the same constants at the
+    same levels and scales. Compare encoding them on every request with the
+    cache.
+    */
+    print_line(__LINE__);
+    cout << "Constants for " << 100 << " more requests:" << endl;
+    parms_id_type x1_parms_id = x1_encrypted.parms_id();
+    parms_id_type x2_parms_id = x2_encrypted.parms_id();
+    chrono::high_resolution_clock::time_point time_start, time_end;
+
+    time_start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < 100; i++)
+    {
+        Plaintext coeff1, coeff2;
+        encoder.encode(1, scale, coeff1);
+        encoder.encode(2, scale, coeff2);
+        evaluator.mod_switch_to_inplace(coeff2, x2_parms_id);
+    }
+    time_end = chrono::high_resolution_clock::now();
+    auto time_encode = chrono::duration_cast<chrono::microseconds>(time_end - time_start);
+
+    time_start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < 100; i++)
+    {
+        constants.get(1, x1_parms_id, x1_encrypted.scale());
+        constants.get(2, x2_parms_id, x2_encrypted.scale());
+    }
+    time_end = chrono::high_resolution_clock::now();
+    auto time_cached = chrono::duration_cast<chrono::microseconds>(time_end - time_start);
+
+    cout << "    + encode + mod_switch every time: " << time_encode.count() / 100 << " microseconds/request" << endl;
+    cout << "    + constant cache: " << time_cached.count() / 100 << " microseconds/request (" << constants.size()
+         << " entries, " << constants.hits() << " hits, " << constants.misses() << " misses)" << endl;
+
+    /*
+    The same circuit through CKKSScaleManager, which relinearizes, rescales,
+    encodes the constants at the right level and scale and aligns levels and
+    scales by itself. None of the steps above have to be written by hand.
+    */
+    print_line(__LINE__);
+    cout << "Evaluate (x+1)^2(x^2+2) with CKKSScaleManager." << endl;
+    CKKSScaleManager manager(context, evaluator, constants, relin_keys);
+    Ciphertext x_encrypted, x_plus_1, x_plus_1_squared, x_squared, x_squared_plus_2, managed_encrypted;
+    encryptor.encrypt(x_plain, x_encrypted);
+    manager.add_plain(x_encrypted, 1, x_plus_1);
+    manager.square(x_plus_1, x_plus_1_squared);
+    manager.square(x_encrypted, x_squared);
+    manager.add_plain(x_squared, 2, x_squared_plus_2);
+    manager.multiply(x_plus_1_squared, x_squared_plus_2, managed_encrypted);
+
+    const CKKSScaleManager::op_counts &counts = manager.stats();
+    cout << "    + " << counts.relinearizations << " relinearizations, " << counts.rescales << " rescales, "
+         << counts.mod_switches << " mod switches, " << counts.scale_corrections << " scale corrections" << endl;
+
+    decryptor.decrypt(managed_encrypted, plain_result);
+    vector<double> managed_result;
+    encoder.decode(plain_result, managed_result);
+    print_vector(managed_result, 3, 7);
+
+    /*
+    The same polynomial from its factors through CKKSPolyEvaluator, which picks
+    a baby-step giant-step schedule and runs it on a CKKSScaleManager.
+    인수들만 넘기면 곱셈 순서와 rescale 위치를 정해서 계산한다.
+    */
+    print_line(__LINE__);
+    cout << "Evaluate (x+1)^2(x^2+2) with CKKSPolyEvaluator." << endl;
+    const vector<vector<double>> factors = { { 1, 1 }, { 1, 1 }, { 2, 0, 1 } };
+    auto poly_plan = CKKSPolyEvaluator::plan(CKKSPolySchedule::expand_factors(factors));
+    cout << "    + plan: depth " << poly_plan.depth << ", " << poly_plan.non_scalar_mults << " ciphertext mults, "
+         << poly_plan.scalar_mults << " constant mults" << endl;
+
+    CKKSScaleManager poly_manager(context, evaluator, constants, relin_keys);
+    CKKSPolyEvaluator poly_evaluator(poly_manager);
+    Ciphertext poly_encrypted;
+    poly_evaluator.evaluate_factors(x_encrypted, factors, poly_encrypted);
+    cout << "    + levels used: " << poly_manager.level(x_encrypted) - poly_manager.level(poly_encrypted) << endl;
+
+    decryptor.decrypt(poly_encrypted, plain_result);
+    vector<double> poly_result;
+    encoder.decode(plain_result, poly_result);
+    print_vector(poly_result, 3, 7);
+
+    double max_error = 0, managed_max_error = 0, poly_max_error = 0;
+    for (size_t i = 0; i < true_result.size(); i++)
+    {
+        max_error = max(max_error, abs(result[i] - true_result[i]));
+        managed_max_error = max(managed_max_error, abs(managed_result[i] - true_result[i]));
+        poly_max_error = max(poly_max_error, abs(poly_result[i] - true_result[i]));
+    }
+    cout << "    + max error: " << max_error << " (by hand), " << managed_max_error << " (CKKSScaleManager), "
+         << poly_max_error << " (CKKSPolyEvaluator)" << endl;
+
     /*
     While we did not show any computations on complex numbers in these examples,
     the CKKSEncoder would allow us to have done that just as easily. Additions
@@ -0,0 +1,321 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "seal/seal.h"
+#include "seal/util/iterator.h"
+#include "seal/util/ntt.h"
+#include "ckks_special_fft.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+/*
+Encodes a long array of values into as many CKKS plaintexts as it takes, on
+several threads, with a vectorized inverse special FFT.
+
+CKKSEncoder::encode 를 벡터 하나씩 한 스레드에서 부르던 것을, 큰 입력 배열을 slot_count
+씩 잘라 thread pool 에서 동시에 encode 하도록 묶은 것. 출력 plaintext 는 미리 할당해 두고
+다음 호출에서도 재사용한다.
+
+Plaintext i holds values[i * slot_count, (i + 1) * slot_count), and the last one
+is padded with zeros. The expensive part of every encode is the inverse special
+FFT over the slots followed by an NTT for every prime. This class does the
+encoding itself, in the same steps as CKKSEncoder:
+
+- the inverse special FFT runs in CKKSSpecialFFT, with AVX-512 or AVX2 when the
+  CPU has them and scalar code otherwise (instruction_set() tells which);
+- the rounded coefficients are reduced modulo every prime and transformed with
+  SEAL's NTT, which uses Intel HEXL when SEAL was built with it;
+- inputs whose coefficients need more than 63 bits (a scale close to the
+  total modulus) go through CKKSEncoder::encode, which handles multiprecision
+  coefficients.
+
+Plaintexts are spread across a thread pool:
+
+- the worker threads are started once and wait for batches, so encode() never
+  creates a thread;
+- every worker has its own FFT scratch (and a slot vector for the
+  CKKSEncoder fallback, which allocates from its thread-local memory pool),
+  so workers share no lock while encoding;
+- destination is resized and every plaintext is reserved to its full size up
+  front, on the calling thread. Passing the same vector to the next call
+  reuses all of that storage.
+
+CKKSSpecialFFT::inverse and CKKSEncoder::encode are const and can be called
+from several threads at once. One CKKSBatchEncoder runs one encode() at a time.
+*/
+class CKKSBatchEncoder
+{
+public:
+    CKKSBatchEncoder(
+        const seal::SEALContext &context, std::size_t num_threads = std::thread::hardware_concurrency(),
+        CKKSSpecialFFT::isa fft_isa = CKKSSpecialFFT::isa::best)
+        : context_(context), encoder_(context),
+          fft_(context.first_context_data()->parms().poly_modulus_degree(), fft_isa)
+    {
+        num_threads = std::max<std::size_t>(num_threads, 1);
+        scratch_.resize(num_threads);
+        for (auto &scratch : scratch_)
+        {
+            scratch.re.resize(fft_.coeff_count());
+            scratch.im.resize(fft_.coeff_count());
+        }
+        for (std::size_t t = 0; t < num_threads; t++)
+        {
+            workers_.emplace_back([this, t]() { worker_loop(t); });
+        }
+    }
+
+    ~CKKSBatchEncoder()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        work_ready_.notify_all();
+        for (auto &worker : workers_)
+        {
+            worker.join();
+        }
+    }
+
+    CKKSBatchEncoder(const CKKSBatchEncoder &) = delete;
+
+    CKKSBatchEncoder &operator=(const CKKSBatchEncoder &) = delete;
+
+    std::size_t slot_count() const
+    {
+        return encoder_.slot_count();
+    }
+
+    std::size_t plaintext_count(std::size_t value_count) const
+    {
+        return (value_count + slot_count() - 1) / slot_count();
+    }
+
+    std::size_t thread_count() const
+    {
+        return workers_.size();
+    }
+
+    CKKSSpecialFFT::isa instruction_set() const
+    {
+        return fft_.instruction_set();
+    }
+
+    /*
+    Encodes values[0, count) at the given parms_id and scale into
+    plaintext_count(count) plaintexts.
+    */
+    void encode(
+        const double *values, std::size_t count, seal::parms_id_type parms_id, double scale,
+        std::vector<seal::Plaintext> &destination)
+    {
+        auto context_data = context_.get_context_data(parms_id);
+        if (!context_data)
+        {
+            throw std::invalid_argument("CKKSBatchEncoder: parms_id is not valid for the context");
+        }
+        if (!(scale > 0) || std::log2(scale) + 1 >= context_data->total_coeff_modulus_bit_count())
+        {
+            throw std::invalid_argument("CKKSBatchEncoder: scale out of bounds");
+        }
+        std::size_t plain_size =
+            context_data->parms().poly_modulus_degree() * context_data->parms().coeff_modulus().size();
+
+        std::size_t num_plaintexts = plaintext_count(count);
+        destination.resize(num_plaintexts);
+        for (auto &plain : destination)
+        {
+            if (plain.capacity() < plain_size)
+            {
+                // an NTT-form plaintext cannot be reserved; encode overwrites parms_id anyway
+                plain.parms_id() = seal::parms_id_zero;
+                plain.reserve(plain_size);
+            }
+        }
+
+        const std::size_t slots = slot_count();
+        run(num_plaintexts, [&](std::size_t i, std::size_t worker) {
+            std::size_t begin = i * slots;
+            std::size_t end = std::min(count, begin + slots);
+            encode_one(values + begin, end - begin, *context_data, scale, destination[i], scratch_[worker]);
+        });
+    }
+
+    void encode(const std::vector<double> &values, double scale, std::vector<seal::Plaintext> &destination)
+    {
+        encode(values.data(), values.size(), context_.first_parms_id(), scale, destination);
+    }
+
+private:
+    struct worker_scratch
+    {
+        std::vector<double> re;
+
+        std::vector<double> im;
+
+        std::vector<double> chunk;
+    };
+
+    void encode_one(
+        const double *values, std::size_t count, const seal::SEALContext::ContextData &context_data, double scale,
+        seal::Plaintext &destination, worker_scratch &scratch) const
+    {
+        const std::size_t n = fft_.coeff_count();
+        fft_.inverse(values, count, scale, scratch.re.data(), scratch.im.data());
+
+        double max_coeff = 0;
+        for (double coeff : scratch.re)
+        {
+            max_coeff = std::max(max_coeff, std::fabs(coeff));
+        }
+        int max_coeff_bit_count = static_cast<int>(std::ceil(std::log2(std::max(max_coeff, 1.0))));
+        if (max_coeff_bit_count >= context_data.total_coeff_modulus_bit_count())
+        {
+            throw std::invalid_argument("CKKSBatchEncoder: encoded values are too large");
+        }
+        if (max_coeff_bit_count >= 63)
+        {
+            scratch.chunk.assign(values, values + count);
+            scratch.chunk.resize(slot_count(), 0.0);
+            encoder_.encode(
+                scratch.chunk, context_data.parms_id(), scale, destination,
+                seal::MemoryManager::GetPool(seal::mm_prof_opt::FORCE_THREAD_LOCAL));
+            return;
+        }
+
+        const auto &coeff_modulus = context_data.parms().coeff_modulus();
+        const std::size_t coeff_modulus_size = coeff_modulus.size();
+        destination.parms_id() = seal::parms_id_zero;
+        destination.resize(n * coeff_modulus_size);
+        std::uint64_t *data = destination.data();
+        for (std::size_t i = 0; i < n; i++)
+        {
+            double coeffd = std::round(scratch.re[i]);
+            bool is_negative = std::signbit(coeffd);
+            std::uint64_t coeffu = static_cast<std::uint64_t>(std::fabs(coeffd));
+            for (std::size_t j = 0; j < coeff_modulus_size; j++)
+            {
+                std::uint64_t reduced = coeff_modulus[j].reduce(coeffu);
+                data[i + j * n] = is_negative && reduced != 0 ? coeff_modulus[j].value() - reduced : reduced;
+            }
+        }
+        seal::util::ntt_negacyclic_harvey(
+            seal::util::RNSIter(data, n), coeff_modulus_size, context_data.small_ntt_tables());
+
+        destination.parms_id() = context_data.parms_id();
+        destination.scale() = scale;
+    }
+
+    /*
+    Runs job(i, worker) for every i in [0, num_jobs) on the workers and
+    returns when all of them are done.
+    */
+    void run(std::size_t num_jobs, const std::function<void(std::size_t, std::size_t)> &job)
+    {
+        if (num_jobs == 0)
+        {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        job_ = &job;
+        num_jobs_ = num_jobs;
+        next_job_ = 0;
+        idle_workers_ = 0;
+        generation_++;
+        work_ready_.notify_all();
+        work_done_.wait(lock, [this]() { return idle_workers_ == workers_.size(); });
+        job_ = nullptr;
+
+        if (error_)
+        {
+            std::exception_ptr error = error_;
+            error_ = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+    void worker_loop(std::size_t worker)
+    {
+        std::size_t seen_generation = 0;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                work_ready_.wait(lock, [&]() { return stop_ || generation_ != seen_generation; });
+                if (stop_)
+                {
+                    return;
+                }
+                seen_generation = generation_;
+            }
+
+            try
+            {
+                for (std::size_t i = next_job_++; i < num_jobs_; i = next_job_++)
+                {
+                    (*job_)(i, worker);
+                }
+            }
+            catch (...)
+            {
+                // e.g. a scale too large for the parms_id; encode() rethrows it
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!error_)
+                {
+                    error_ = std::current_exception();
+                }
+                next_job_ = num_jobs_;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                idle_workers_++;
+            }
+            work_done_.notify_one();
+        }
+    }
+
+    const seal::SEALContext &context_;
+
+    seal::CKKSEncoder encoder_;
+
+    CKKSSpecialFFT fft_;
+
+    std::vector<worker_scratch> scratch_;
+
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+
+    std::condition_variable work_ready_;
+
+    std::condition_variable work_done_;
+
+    const std::function<void(std::size_t, std::size_t)> *job_ = nullptr;
+
+    std::size_t num_jobs_ = 0;
+
+    std::atomic<std::size_t> next_job_{ 0 };
+
+    std::size_t idle_workers_ = 0;
+
+    std::size_t generation_ = 0;
+
+    std::exception_ptr error_;
+
+    bool stop_ = false;
+};
@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "seal/seal.h"
+#include <array>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+/*
+Cache of constants encoded as CKKS plaintexts.
+
+9_ckks_task.cpp 에서 2, 1 을 encode 한 뒤 mod_switch_to_inplace 로 level 을 맞추던 부분을
+(value, parms_id, scale) 별로 한 번만 encode 해 두고 재사용하도록 만든 것.
+
+A plaintext is encoded directly at the parms_id (level) and the exact scale of
+the ciphertext it will be combined with, so add_plain / multiply_plain can use
+it without any mod_switch_to_inplace and without fixing scales by hand. The
+result of CKKSEncoder::encode is already in NTT form at that level, so a hit
+costs one map lookup instead of an encode (IFFT + NTT over every prime).
+
+Entries live as long as the cache; references returned by get() stay valid
+until clear() is called. The cache can be shared between threads.
+*/
+class CKKSConstantCache
+{
+public:
+    CKKSConstantCache(const seal::CKKSEncoder &encoder) : encoder_(encoder)
+    {}
+
+    /*
+    Returns value encoded in every slot at the given parms_id and scale,
+    encoding it on the first request only.
+    */
+    const seal::Plaintext &get(double value, const seal::parms_id_type &parms_id, double scale)
+    {
+        key_type key{ value, parms_id, scale };
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = cache_.find(key);
+        if (it != cache_.end())
+        {
+            hits_++;
+            return it->second;
+        }
+
+        misses_++;
+        seal::Plaintext &plain = cache_[key];
+        encoder_.encode(value, parms_id, scale, plain);
+        return plain;
+    }
+
+    /*
+    Same as get(), at the level and scale of the given ciphertext.
+    */
+    const seal::Plaintext &get_for(double value, const seal::Ciphertext &encrypted)
+    {
+        return get(value, encrypted.parms_id(), encrypted.scale());
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cache_.clear();
+    }
+
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return cache_.size();
+    }
+
+    std::size_t hits() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return hits_;
+    }
+
+    std::size_t misses() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return misses_;
+    }
+
+private:
+    // parms_id_type is a std::array<std::uint64_t, 4>, which orders lexicographically
+    using key_type = std::tuple<double, seal::parms_id_type, double>;
+
+    const seal::CKKSEncoder &encoder_;
+
+    mutable std::mutex mutex_;
+
+    std::map<key_type, seal::Plaintext> cache_;
+
+    std::size_t hits_ = 0;
+
+    std::size_t misses_ = 0;
+};
@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+/*
+Galois keys for every power-of-two step against keys for the listed steps only.
+
+9_ckks_task.cpp 와 같은 파라미터로 create_galois_keys() (모든 2의 거듭제곱 step, 양방향) 와
+create_galois_keys(steps) 를 각각 만들어 key 개수, 생성 시간, 직렬화 크기를 비교한다.
+
+usage: ckks_galois_key_benchmark [steps=2]   (comma separated, e.g. 1,2,-3)
+*/
+
+#include "seal/seal.h"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace seal;
+
+struct keygen_result
+{
+    size_t keys;
+
+    double ms;
+
+    double mb;
+};
+
+keygen_result time_keygen(KeyGenerator &keygen, const vector<int> *steps)
+{
+    GaloisKeys gal_keys;
+    auto time_start = chrono::high_resolution_clock::now();
+    if (steps)
+    {
+        keygen.create_galois_keys(*steps, gal_keys);
+    }
+    else
+    {
+        keygen.create_galois_keys(gal_keys);
+    }
+    auto time_end = chrono::high_resolution_clock::now();
+    return { gal_keys.size(), chrono::duration_cast<chrono::microseconds>(time_end - time_start).count() / 1e3,
+             static_cast<double>(gal_keys.save_size(compr_mode_type::none)) / (1 << 20) };
+}
+
+int main(int argc, char *argv[])
+{
+    string steps_arg = argc > 1 ? argv[1] : "2";
+    vector<int> steps;
+    stringstream list(steps_arg);
+    string item;
+    while (getline(list, item, ','))
+    {
+        steps.push_back(stoi(item));
+    }
+
+    EncryptionParameters parms(scheme_type::ckks);
+    size_t poly_modulus_degree = 16384;
+    parms.set_poly_modulus_degree(poly_modulus_degree);
+    parms.set_coeff_modulus(CoeffModulus::Create(poly_modulus_degree, { 60, 50, 50, 50, 50, 60 }));
+    SEALContext context(parms);
+    KeyGenerator keygen(context);
+
+    keygen_result all = time_keygen(keygen, nullptr);
+    keygen_result selected = time_keygen(keygen, &steps);
+
+    cout << "Galois keys, N = " << poly_modulus_degree << ":" << endl;
+    cout << fixed << setprecision(1);
+    cout << "    + all power-of-two steps: " << all.keys << " keys, " << all.ms << " ms, " << all.mb << " MB" << endl;
+    cout << "    + steps " << steps_arg << ": " << selected.keys << " keys, " << selected.ms << " ms, "
+         << selected.mb << " MB" << endl;
+
+    return 0;
+}
@@ -0,0 +1,137 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "seal/seal.h"
+#include "ckks_constant_cache.h"
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+/*
+Evaluates the (x+1)^2(x^2+2) circuit of 9_ckks_task.cpp on many inputs at once.
+
+9_ckks_task.cpp 의 회로를 여러 입력에 대해 여러 스레드로 돌리는 driver. 스레드마다
+thread-local memory pool 을 쓰고, 중간 ciphertext 버퍼는 반복마다 다시 할당하지 않는다.
+
+Every Evaluator, Encryptor and CKKSEncoder call takes a MemoryPoolHandle that
+defaults to MemoryManager::GetPool(), the global pool. Allocations from the
+global pool take its mutex, so with many threads the workers queue up on it.
+With thread_local_pools each worker instead passes
+MemoryManager::GetPool(mm_prof_opt::FORCE_THREAD_LOCAL), which has no lock to
+share.
+
+Each worker also keeps its plaintext and intermediate ciphertexts for its whole
+run (the results it returns come from the caller's pool, see run()). Once they have grown to full size on the first input, later inputs write
+into the same storage and do not allocate. The constants 1 and 2 come from a
+shared CKKSConstantCache, which is locked only once per worker and not once per
+input: every input goes through the same levels and scales.
+
+Evaluator, Encryptor and CKKSEncoder are only used through const methods, which
+SEAL allows from several threads at once.
+*/
+class CKKSParallelDriver
+{
+public:
+    CKKSParallelDriver(
+        const seal::SEALContext &context, const seal::PublicKey &public_key, const seal::RelinKeys &relin_keys,
+        double scale)
+        : encoder_(context), encryptor_(context, public_key), evaluator_(context),
+          relin_keys_(relin_keys), constants_(encoder_), scale_(scale)
+    {}
+
+    /*
+    Encodes, encrypts and evaluates every input with num_threads workers.
+    result[i] is the circuit on inputs[i], rescaled. It is allocated from the
+    caller's pool (MemoryManager::GetPool()): a thread-local pool is a
+    single-threaded MemoryPoolST, and its objects must not be handed to or
+    destroyed on another thread. Only the worker's temporaries use it.
+    */
+    std::vector<seal::Ciphertext> run(
+        const std::vector<std::vector<double>> &inputs, std::size_t num_threads, bool thread_local_pools = true)
+    {
+        seal::MemoryPoolHandle result_pool = seal::MemoryManager::GetPool();
+        std::vector<seal::Ciphertext> results(inputs.size());
+        std::atomic<std::size_t> next{ 0 };
+
+        auto worker = [&]() {
+            seal::MemoryPoolHandle pool = thread_local_pools
+                                              ? seal::MemoryManager::GetPool(seal::mm_prof_opt::FORCE_THREAD_LOCAL)
+                                              : seal::MemoryManager::GetPool();
+
+            // reused for every input this worker takes
+            seal::Plaintext x_plain(pool);
+            seal::Ciphertext x1(pool);
+            seal::Ciphertext x2(pool);
+            const seal::Plaintext *plain_one = nullptr;
+            const seal::Plaintext *plain_two = nullptr;
+
+            for (std::size_t i = next++; i < inputs.size(); i = next++)
+            {
+                encoder_.encode(inputs[i], scale_, x_plain, pool);
+                encryptor_.encrypt(x_plain, x1, pool);
+
+                // x^2 + 2
+                evaluator_.square(x1, x2, pool);
+                evaluator_.relinearize_inplace(x2, relin_keys_, pool);
+                evaluator_.rescale_to_next_inplace(x2, pool);
+                if (!plain_two)
+                {
+                    plain_one = &constants_.get_for(1, x1);
+                    plain_two = &constants_.get_for(2, x2);
+                }
+                evaluator_.add_plain_inplace(x2, *plain_two);
+
+                // (x + 1)^2
+                evaluator_.add_plain_inplace(x1, *plain_one);
+                evaluator_.square_inplace(x1, pool);
+                evaluator_.relinearize_inplace(x1, relin_keys_, pool);
+                evaluator_.rescale_to_next_inplace(x1, pool);
+
+                // (x + 1)^2 (x^2 + 2)
+                evaluator_.multiply_inplace(x1, x2, pool);
+                evaluator_.relinearize_inplace(x1, relin_keys_, pool);
+                results[i] = seal::Ciphertext(result_pool);
+                evaluator_.rescale_to_next(x1, results[i], pool);
+            }
+        };
+
+        if (num_threads <= 1)
+        {
+            worker();
+            return results;
+        }
+
+        std::vector<std::thread> threads;
+        threads.reserve(num_threads);
+        for (std::size_t t = 0; t < num_threads; t++)
+        {
+            threads.emplace_back(worker);
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+        return results;
+    }
+
+    const seal::CKKSEncoder &encoder() const
+    {
+        return encoder_;
+    }
+
+private:
+    seal::CKKSEncoder encoder_;
+
+    seal::Encryptor encryptor_;
+
+    seal::Evaluator evaluator_;
+
+    const seal::RelinKeys &relin_keys_;
+
+    CKKSConstantCache constants_;
+
+    double scale_;
+};
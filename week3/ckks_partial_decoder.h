@@ -0,0 +1,218 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "seal/seal.h"
+#include "seal/util/iterator.h"
+#include "seal/util/ntt.h"
+#include "seal/util/rns.h"
+#include "seal/util/uintcore.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+/*
+Decodes only some slots of a CKKS plaintext.
+
+CKKSEncoder::decode 는 항상 slot_count 개를 전부 계산하지만, 클라이언트는 보통 앞의 몇 개만
+읽는다. 필요한 slot 만 직접 계산해서 FFT 를 건너뛰는 decoder.
+
+CKKSEncoder::decode does three things: an inverse NTT for every prime, CRT
+composition of the coefficients, and a forward special FFT of N log N complex
+operations that evaluates the plaintext polynomial m(X) at every slot root.
+Slot j is m(psi^(3^j mod 2N)) with psi = exp(2 pi i / 2N), in the same order as
+CKKSEncoder. A single slot is therefore
+
+    sum_i c_i cos(2 pi (3^j i mod 2N) / 2N)
+
+for its real part, N multiply-adds from a cosine table. decode() computes just
+the requested slots that way, as long as there are at most direct_limit() of
+them (log2 N by default, about where k N drops below the FFT). For more slots
+it runs CKKSEncoder::decode and picks the requested ones.
+
+The inverse NTT and CRT composition cover all N coefficients in either case,
+because every slot depends on every coefficient. Only the FFT and the
+slot_count-long output are saved. This matters most for ciphertexts rescaled
+down to one or two primes, where the FFT is most of the decoding.
+*/
+class CKKSPartialDecoder
+{
+public:
+    CKKSPartialDecoder(const seal::SEALContext &context)
+        : context_(context), encoder_(context),
+          coeff_count_(context.first_context_data()->parms().poly_modulus_degree())
+    {
+        const double pi = std::acos(-1.0);
+        std::size_t m = 2 * coeff_count_;
+        cos_table_.resize(m);
+        for (std::size_t k = 0; k < m; k++)
+        {
+            cos_table_[k] = std::cos(2 * pi * static_cast<double>(k) / static_cast<double>(m));
+        }
+
+        for (std::size_t n = coeff_count_; n > 1; n >>= 1)
+        {
+            direct_limit_++;
+        }
+    }
+
+    /*
+    destination[i] is slot slots[i] of plain, as CKKSEncoder::decode would
+    give it.
+    */
+    void decode(
+        const seal::Plaintext &plain, const std::vector<std::size_t> &slots, std::vector<double> &destination,
+        seal::MemoryPoolHandle pool = seal::MemoryManager::GetPool()) const
+    {
+        const std::size_t slot_count = coeff_count_ / 2;
+        for (std::size_t slot : slots)
+        {
+            if (slot >= slot_count)
+            {
+                throw std::out_of_range("CKKSPartialDecoder: slot index out of range");
+            }
+        }
+
+        destination.resize(slots.size());
+        if (slots.size() > direct_limit_)
+        {
+            std::vector<double> all;
+            encoder_.decode(plain, all, pool);
+            for (std::size_t i = 0; i < slots.size(); i++)
+            {
+                destination[i] = all[slots[i]];
+            }
+            return;
+        }
+
+        std::vector<double> coeffs = coefficients(plain, pool);
+        const std::uint64_t m = 2 * coeff_count_;
+        for (std::size_t i = 0; i < slots.size(); i++)
+        {
+            std::uint64_t root = galois_power(slots[i]);
+            std::uint64_t index = 0;
+            double sum = 0;
+            for (std::size_t c = 0; c < coeff_count_; c++)
+            {
+                sum += coeffs[c] * cos_table_[index];
+                index += root;
+                if (index >= m)
+                {
+                    index -= m;
+                }
+            }
+            destination[i] = sum;
+        }
+    }
+
+    /*
+    The first k slots.
+    */
+    void decode_first(
+        const seal::Plaintext &plain, std::size_t k, std::vector<double> &destination,
+        seal::MemoryPoolHandle pool = seal::MemoryManager::GetPool()) const
+    {
+        std::vector<std::size_t> slots(k);
+        for (std::size_t i = 0; i < k; i++)
+        {
+            slots[i] = i;
+        }
+        decode(plain, slots, destination, pool);
+    }
+
+    std::size_t direct_limit() const
+    {
+        return direct_limit_;
+    }
+
+    void set_direct_limit(std::size_t limit)
+    {
+        direct_limit_ = limit;
+    }
+
+private:
+    // 3^slot mod 2N
+    std::uint64_t galois_power(std::size_t slot) const
+    {
+        const std::uint64_t m = 2 * coeff_count_;
+        std::uint64_t power = 1;
+        std::uint64_t base = 3;
+        for (std::size_t e = slot; e > 0; e >>= 1)
+        {
+            if (e & 1)
+            {
+                power = (power * base) & (m - 1);
+            }
+            base = (base * base) & (m - 1);
+        }
+        return power;
+    }
+
+    /*
+    Coefficients of plain divided by its scale, centered around 0; the first
+    half of CKKSEncoder::decode.
+    */
+    std::vector<double> coefficients(const seal::Plaintext &plain, seal::MemoryPoolHandle pool) const
+    {
+        if (!plain.is_ntt_form())
+        {
+            throw std::invalid_argument("CKKSPartialDecoder: plain is not in NTT form");
+        }
+        auto context_data = context_.get_context_data(plain.parms_id());
+        if (!context_data)
+        {
+            throw std::invalid_argument("CKKSPartialDecoder: plain is not valid for the context");
+        }
+
+        const std::size_t coeff_modulus_size = context_data->parms().coeff_modulus().size();
+        std::vector<std::uint64_t> plain_copy(plain.data(), plain.data() + coeff_count_ * coeff_modulus_size);
+
+        seal::util::inverse_ntt_negacyclic_harvey(
+            seal::util::RNSIter(plain_copy.data(), coeff_count_), coeff_modulus_size,
+            context_data->small_ntt_tables());
+        context_data->rns_tool()->base_q()->compose_array(plain_copy.data(), coeff_count_, pool);
+
+        const std::uint64_t *decryption_modulus = context_data->total_coeff_modulus();
+        const std::uint64_t *upper_half_threshold = context_data->upper_half_threshold();
+        const double two_pow_64 = std::pow(2.0, 64);
+        const double inv_scale = 1.0 / plain.scale();
+
+        std::vector<double> coeffs(coeff_count_, 0.0);
+        for (std::size_t i = 0; i < coeff_count_; i++)
+        {
+            const std::uint64_t *value = plain_copy.data() + i * coeff_modulus_size;
+            bool negative =
+                seal::util::is_greater_than_or_equal_uint(value, upper_half_threshold, coeff_modulus_size);
+            double scaled_two_pow_64 = inv_scale;
+            for (std::size_t j = 0; j < coeff_modulus_size; j++, scaled_two_pow_64 *= two_pow_64)
+            {
+                if (!negative)
+                {
+                    coeffs[i] += static_cast<double>(value[j]) * scaled_two_pow_64;
+                }
+                else if (value[j] > decryption_modulus[j])
+                {
+                    coeffs[i] += static_cast<double>(value[j] - decryption_modulus[j]) * scaled_two_pow_64;
+                }
+                else
+                {
+                    coeffs[i] -= static_cast<double>(decryption_modulus[j] - value[j]) * scaled_two_pow_64;
+                }
+            }
+        }
+        return coeffs;
+    }
+
+    const seal::SEALContext &context_;
+
+    seal::CKKSEncoder encoder_;
+
+    std::size_t coeff_count_;
+
+    std::vector<double> cos_table_;
+
+    std::size_t direct_limit_ = 0;
+};
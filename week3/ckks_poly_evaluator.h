@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "seal/seal.h"
+#include "ckks_scale_manager.h"
+#include "ckks_poly_schedule.h"
+#include <cstdint>
+#include <vector>
+
+/*
+Evaluates a polynomial on a CKKS ciphertext from its coefficients.
+
+9_ckks_task.cpp 에서 (x+1)^2(x^2+2) 를 square / multiply / add_plain 으로 풀어 쓰던 것을
+계수 (또는 인수들의 곱) 만 넘기면 계산하도록 한 것. baby-step giant-step schedule
+(ckks_poly_schedule.h) 을 SEAL 위에서 돌린다.
+
+Every operation goes through a CKKSScaleManager, which relinearizes, rescales,
+encodes the coefficients at the right level and scale, and aligns the levels
+and scales of the powers of x before they are added. plan() gives the depth
+and the number of multiplications of the schedule; scale corrections the
+manager has to insert when two powers reach an addition at the same level
+with scales that really differ (not just by the rounding of rescale, which
+SEAL tolerates) can cost extra levels on top of it (see
+CKKSScaleManager::stats()).
+*/
+class CKKSPolyEvaluator
+{
+public:
+    CKKSPolyEvaluator(CKKSScaleManager &manager) : manager_(manager)
+    {}
+
+    /*
+    destination = coefficients[0] + coefficients[1] x + ... + coefficients[d] x^d
+    */
+    void evaluate(
+        const seal::Ciphertext &x, const std::vector<double> &coefficients, seal::Ciphertext &destination,
+        std::uint32_t extra_depth = 0)
+    {
+        backend backend{ manager_, x };
+        destination = CKKSPolySchedule::evaluate(backend, coefficients, extra_depth);
+    }
+
+    /*
+    A polynomial given as a product of factors, e.g. (x+1)^2(x^2+2) is
+    { { 1, 1 }, { 1, 1 }, { 2, 0, 1 } }.
+    */
+    void evaluate_factors(
+        const seal::Ciphertext &x, const std::vector<std::vector<double>> &factors, seal::Ciphertext &destination,
+        std::uint32_t extra_depth = 0)
+    {
+        evaluate(x, CKKSPolySchedule::expand_factors(factors), destination, extra_depth);
+    }
+
+    static CKKSPolySchedule::plan_type plan(const std::vector<double> &coefficients, std::uint32_t extra_depth = 0)
+    {
+        return CKKSPolySchedule::make_plan(coefficients, extra_depth);
+    }
+
+private:
+    struct backend
+    {
+        using value_type = seal::Ciphertext;
+
+        CKKSScaleManager &manager;
+
+        const seal::Ciphertext &x;
+
+        value_type input()
+        {
+            return x;
+        }
+
+        value_type mult(const value_type &a, const value_type &b)
+        {
+            value_type result;
+            if (&a == &b)
+            {
+                manager.square(a, result);
+            }
+            else
+            {
+                manager.multiply(a, b, result);
+            }
+            return result;
+        }
+
+        value_type mult_const(const value_type &a, double c)
+        {
+            value_type result;
+            manager.multiply_plain(a, c, result);
+            return result;
+        }
+
+        value_type add(const value_type &a, const value_type &b)
+        {
+            value_type result;
+            manager.add(a, b, result);
+            return result;
+        }
+
+        value_type add_const(const value_type &a, double c)
+        {
+            value_type result;
+            manager.add_plain(a, c, result);
+            return result;
+        }
+    };
+
+    CKKSScaleManager &manager_;
+};
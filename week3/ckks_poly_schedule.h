@@ -0,0 +1,356 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/*
+Baby-step giant-step (Paterson-Stockmeyer) schedule for polynomial evaluation.
+
+ckks_poly_evaluator.h 가 쓰는 부분. SEAL 에도 의존하지 않고, 곱셈/덧셈을 backend 에 맡긴다.
+
+Evaluates p(x) = c[0] + c[1] x + ... + c[d] x^d on any backend:
+
+- baby steps x, x^2, ..., x^(k-1) (k a power of two), each x^i computed at
+  depth ceil(log2 i);
+- giant steps x^k, x^(2k), x^(4k), ... by repeated squaring;
+- p is split recursively as p = q * x^(k 2^j) + r until every piece has
+  degree < k, and the pieces are linear combinations of the baby steps.
+
+The number of non-scalar multiplications is about k + d/k + log2(d/k) instead
+of d. A coefficient other than 0 and 1 costs a scalar multiplication, and so
+one level, on the power it multiplies. For general coefficients the depth is
+ceil(log2(d+1)): ceil(log2 d) for x^d, plus one when d is a power of two and
+x^d itself is multiplied by a coefficient. Coefficients equal to 1 on the
+deepest powers save that level, e.g. (x+1)^2 (x^2+2) = x^4 + 2x^3 + 3x^2 + 4x + 2
+has depth 2. make_plan() reports the exact depth; it chooses k to minimize the
+depth first and the number of non-scalar multiplications second.
+
+A backend provides input(), mult(), mult_const(), add() and add_const() on its
+value_type; additions are assumed to cost no depth.
+*/
+class CKKSPolySchedule
+{
+public:
+    /*
+    Cost of a schedule, computed without touching any ciphertext.
+    */
+    struct plan_type
+    {
+        std::uint32_t baby_steps = 1;
+
+        std::uint32_t depth = 0;
+
+        std::uint32_t non_scalar_mults = 0;
+
+        std::uint32_t scalar_mults = 0;
+    };
+
+    /*
+    Multiplies out a product of factors, e.g. (x+1)^2(x^2+2) is
+    { { 1, 1 }, { 1, 1 }, { 2, 0, 1 } }. Each factor lists its coefficients
+    from degree 0 upwards.
+    */
+    static std::vector<double> expand_factors(const std::vector<std::vector<double>> &factors)
+    {
+        std::vector<double> result = { 1.0 };
+        for (const auto &factor : factors)
+        {
+            if (factor.empty())
+            {
+                continue;
+            }
+            std::vector<double> next(result.size() + factor.size() - 1, 0.0);
+            for (std::size_t i = 0; i < result.size(); i++)
+            {
+                for (std::size_t j = 0; j < factor.size(); j++)
+                {
+                    next[i + j] += result[i] * factor[j];
+                }
+            }
+            result = std::move(next);
+        }
+        return result;
+    }
+
+    /*
+    Finds the number of baby steps with the lowest depth, and among those the
+    lowest number of non-scalar multiplications. With extra_depth > 0,
+    schedules up to extra_depth levels deeper than the minimum are accepted if
+    they need fewer non-scalar multiplications.
+    */
+    static plan_type make_plan(const std::vector<double> &coefficients, std::uint32_t extra_depth = 0)
+    {
+        std::vector<double> coeffs = trim(coefficients);
+        if (coeffs.size() < 2)
+        {
+            return plan_type();
+        }
+
+        std::uint32_t degree = static_cast<std::uint32_t>(coeffs.size() - 1);
+        std::vector<plan_type> plans;
+        for (std::uint32_t k = 1; k <= 2 * degree; k *= 2)
+        {
+            plan_backend backend;
+            run(backend, coeffs, k);
+
+            plan_type plan;
+            plan.baby_steps = k;
+            plan.depth = backend.depth;
+            plan.non_scalar_mults = backend.non_scalar_mults;
+            plan.scalar_mults = backend.scalar_mults;
+            plans.push_back(plan);
+        }
+
+        std::uint32_t min_depth = plans[0].depth;
+        for (const auto &plan : plans)
+        {
+            min_depth = std::min(min_depth, plan.depth);
+        }
+
+        plan_type best;
+        bool found = false;
+        for (const auto &plan : plans)
+        {
+            if (plan.depth > min_depth + extra_depth)
+            {
+                continue;
+            }
+            if (!found || plan.non_scalar_mults < best.non_scalar_mults ||
+                (plan.non_scalar_mults == best.non_scalar_mults && plan.depth < best.depth))
+            {
+                best = plan;
+                found = true;
+            }
+        }
+        return best;
+    }
+
+    /*
+    Runs the planned schedule on backend; the polynomial must have degree at
+    least 1.
+    */
+    template <class Backend>
+    static typename Backend::value_type evaluate(
+        Backend &backend, const std::vector<double> &coefficients, std::uint32_t extra_depth = 0)
+    {
+        std::vector<double> coeffs = trim(coefficients);
+        if (coeffs.size() < 2)
+        {
+            throw std::invalid_argument("CKKSPolySchedule: polynomial must have degree at least 1");
+        }
+
+        plan_type plan = make_plan(coeffs, extra_depth);
+        return run(backend, coeffs, plan.baby_steps).value;
+    }
+
+private:
+    // a piece of the result: either the plain constant c, or an encrypted value
+    template <class Value>
+    struct term
+    {
+        bool is_const = true;
+
+        double c = 0.0;
+
+        Value value{};
+    };
+
+    // plan_backend only tracks depth and counts
+    struct plan_value
+    {
+        std::uint32_t depth = 0;
+    };
+
+    struct plan_backend
+    {
+        using value_type = plan_value;
+
+        std::uint32_t depth = 0;
+
+        std::uint32_t non_scalar_mults = 0;
+
+        std::uint32_t scalar_mults = 0;
+
+        value_type input()
+        {
+            return value_type{ 0 };
+        }
+
+        value_type mult(const value_type &a, const value_type &b)
+        {
+            non_scalar_mults++;
+            return track(value_type{ std::max(a.depth, b.depth) + 1 });
+        }
+
+        value_type mult_const(const value_type &a, double)
+        {
+            scalar_mults++;
+            return track(value_type{ a.depth + 1 });
+        }
+
+        value_type add(const value_type &a, const value_type &b)
+        {
+            return track(value_type{ std::max(a.depth, b.depth) });
+        }
+
+        value_type add_const(const value_type &a, double)
+        {
+            return a;
+        }
+
+        value_type track(value_type v)
+        {
+            depth = std::max(depth, v.depth);
+            return v;
+        }
+    };
+
+    static std::vector<double> trim(std::vector<double> coeffs)
+    {
+        while (!coeffs.empty() && coeffs.back() == 0.0)
+        {
+            coeffs.pop_back();
+        }
+        return coeffs;
+    }
+
+    template <class Backend>
+    class schedule
+    {
+    public:
+        using value_type = typename Backend::value_type;
+
+        schedule(Backend &backend, std::uint32_t k) : backend_(backend), k_(k)
+        {
+            powers_[1] = backend_.input();
+        }
+
+        // x^i, computed on demand as x^(2^t) * x^(i - 2^t) so that its depth is ceil(log2 i)
+        const value_type &power(std::uint32_t i)
+        {
+            auto it = powers_.find(i);
+            if (it != powers_.end())
+            {
+                return it->second;
+            }
+
+            std::uint32_t high = 1;
+            while (high * 2 <= i)
+            {
+                high *= 2;
+            }
+
+            value_type v;
+            if (high == i)
+            {
+                v = backend_.mult(power(i / 2), power(i / 2));
+            }
+            else
+            {
+                v = backend_.mult(power(high), power(i - high));
+            }
+            return powers_[i] = std::move(v);
+        }
+
+        term<value_type> eval(const std::vector<double> &coeffs, std::size_t begin, std::size_t end)
+        {
+            std::size_t length = end - begin;
+            if (length <= k_)
+            {
+                return leaf(coeffs, begin, end);
+            }
+
+            // split at the largest giant step k * 2^j below length
+            std::uint32_t split = k_;
+            while (static_cast<std::size_t>(split) * 2 < length)
+            {
+                split *= 2;
+            }
+
+            term<value_type> q = eval(coeffs, begin + split, end);
+            term<value_type> r = eval(coeffs, begin, begin + split);
+
+            term<value_type> result;
+            if (q.is_const)
+            {
+                if (q.c == 0.0)
+                {
+                    return r;
+                }
+                result = encrypted(q.c == 1.0 ? power(split) : backend_.mult_const(power(split), q.c));
+            }
+            else
+            {
+                result = encrypted(backend_.mult(q.value, power(split)));
+            }
+            return combine(std::move(result), r);
+        }
+
+    private:
+        term<value_type> leaf(const std::vector<double> &coeffs, std::size_t begin, std::size_t end)
+        {
+            term<value_type> result;
+            result.c = coeffs[begin];
+            for (std::size_t i = begin + 1; i < end; i++)
+            {
+                if (coeffs[i] == 0.0)
+                {
+                    continue;
+                }
+                std::uint32_t exponent = static_cast<std::uint32_t>(i - begin);
+                value_type t = coeffs[i] == 1.0 ? power(exponent) : backend_.mult_const(power(exponent), coeffs[i]);
+                result.value = result.is_const ? std::move(t) : backend_.add(result.value, t);
+                result.is_const = false;
+            }
+            // constants are added last, they cost no depth
+            if (!result.is_const && result.c != 0.0)
+            {
+                result.value = backend_.add_const(result.value, result.c);
+            }
+            return result;
+        }
+
+        term<value_type> combine(term<value_type> a, const term<value_type> &b)
+        {
+            if (!b.is_const)
+            {
+                a.value = backend_.add(a.value, b.value);
+            }
+            else if (b.c != 0.0)
+            {
+                a.value = backend_.add_const(a.value, b.c);
+            }
+            return a;
+        }
+
+        static term<value_type> encrypted(value_type v)
+        {
+            term<value_type> t;
+            t.is_const = false;
+            t.value = std::move(v);
+            return t;
+        }
+
+        Backend &backend_;
+
+        std::uint32_t k_;
+
+        std::map<std::uint32_t, value_type> powers_;
+    };
+
+    template <class Backend>
+    static term<typename Backend::value_type> run(
+        Backend &backend, const std::vector<double> &coeffs, std::uint32_t k)
+    {
+        schedule<Backend> s(backend, k);
+        return s.eval(coeffs, 0, coeffs.size());
+    }
+};
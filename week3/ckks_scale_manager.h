@@ -0,0 +1,206 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "seal/seal.h"
+#include "seal/util/common.h"
+#include "ckks_constant_cache.h"
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+/*
+Level and exact-scale bookkeeping for CKKS circuits on top of seal::Evaluator.
+
+9_ckks_task.cpp 에서 손으로 하던 x2_encrypted.scale() = pow(2.0, 50) 와 상수의
+mod_switch_to_inplace 를 대신 해 주는 layer. 연산마다 level 과 정확한 scale 을 보고
+필요한 만큼만 mod switch / scale 보정을 넣는다.
+
+- multiply() and square() relinearize and rescale right away, so every
+  ciphertext coming out of the manager has a scale close to the initial one.
+- add_plain() and multiply_plain() encode the constant at the parms_id of the
+  ciphertext through a CKKSConstantCache, so a constant never needs a mod
+  switch. For add_plain() the constant gets the exact scale of the ciphertext.
+  For multiply_plain() it gets the scale of the prime the following rescale
+  drops, so the product comes back to exactly the scale it had before.
+- add(), sub() and multiply() bring both operands to the lower of the two
+  levels first. If the scales of an addition differ, the operand at the higher
+  level is multiplied by 1 encoded at the correcting scale. The rescale that
+  follows lands it one level down at exactly the scale of the other operand.
+  That uses a level drop the mod switch would have spent anyway. Only when both
+  operands are already at the same level does the correction cost each of them
+  a level.
+
+Scales are never overwritten, so the decrypted values carry no error from a
+forced scale. stats() counts the operations the manager inserted.
+*/
+class CKKSScaleManager
+{
+public:
+    struct op_counts
+    {
+        std::size_t relinearizations = 0;
+
+        std::size_t rescales = 0;
+
+        std::size_t mod_switches = 0;
+
+        std::size_t scale_corrections = 0;
+    };
+
+    CKKSScaleManager(
+        const seal::SEALContext &context, const seal::Evaluator &evaluator, CKKSConstantCache &constants,
+        const seal::RelinKeys &relin_keys)
+        : context_(context), evaluator_(evaluator), constants_(constants), relin_keys_(relin_keys)
+    {}
+
+    void add(const seal::Ciphertext &a, const seal::Ciphertext &b, seal::Ciphertext &destination)
+    {
+        seal::Ciphertext b_aligned = b;
+        destination = a;
+        align_for_add(destination, b_aligned);
+        evaluator_.add_inplace(destination, b_aligned);
+    }
+
+    void sub(const seal::Ciphertext &a, const seal::Ciphertext &b, seal::Ciphertext &destination)
+    {
+        seal::Ciphertext b_aligned = b;
+        destination = a;
+        align_for_add(destination, b_aligned);
+        evaluator_.sub_inplace(destination, b_aligned);
+    }
+
+    void multiply(const seal::Ciphertext &a, const seal::Ciphertext &b, seal::Ciphertext &destination)
+    {
+        seal::Ciphertext b_aligned = b;
+        destination = a;
+        align_levels(destination, b_aligned);
+        evaluator_.multiply_inplace(destination, b_aligned);
+        relinearize_and_rescale(destination);
+    }
+
+    void square(const seal::Ciphertext &a, seal::Ciphertext &destination)
+    {
+        evaluator_.square(a, destination);
+        relinearize_and_rescale(destination);
+    }
+
+    void add_plain(const seal::Ciphertext &a, double value, seal::Ciphertext &destination)
+    {
+        destination = a;
+        evaluator_.add_plain_inplace(destination, constants_.get_for(value, destination));
+    }
+
+    void multiply_plain(const seal::Ciphertext &a, double value, seal::Ciphertext &destination)
+    {
+        destination = a;
+        double prime = static_cast<double>(last_prime(destination.parms_id()));
+        evaluator_.multiply_plain_inplace(destination, constants_.get(value, destination.parms_id(), prime));
+        rescale(destination);
+    }
+
+    std::size_t level(const seal::Ciphertext &encrypted) const
+    {
+        return context_.get_context_data(encrypted.parms_id())->chain_index();
+    }
+
+    const op_counts &stats() const
+    {
+        return stats_;
+    }
+
+private:
+    std::uint64_t last_prime(const seal::parms_id_type &parms_id) const
+    {
+        auto context_data = context_.get_context_data(parms_id);
+        if (!context_data->next_context_data())
+        {
+            throw std::logic_error("CKKSScaleManager: no level left to rescale");
+        }
+        return context_data->parms().coeff_modulus().back().value();
+    }
+
+    void relinearize_and_rescale(seal::Ciphertext &encrypted)
+    {
+        evaluator_.relinearize_inplace(encrypted, relin_keys_);
+        stats_.relinearizations++;
+        rescale(encrypted);
+    }
+
+    void rescale(seal::Ciphertext &encrypted)
+    {
+        evaluator_.rescale_to_next_inplace(encrypted);
+        stats_.rescales++;
+    }
+
+    void mod_switch_to(seal::Ciphertext &encrypted, const seal::parms_id_type &parms_id)
+    {
+        if (encrypted.parms_id() != parms_id)
+        {
+            evaluator_.mod_switch_to_inplace(encrypted, parms_id);
+            stats_.mod_switches++;
+        }
+    }
+
+    void align_levels(seal::Ciphertext &a, seal::Ciphertext &b)
+    {
+        if (level(a) > level(b))
+        {
+            mod_switch_to(a, b.parms_id());
+        }
+        else
+        {
+            mod_switch_to(b, a.parms_id());
+        }
+    }
+
+    /*
+    Multiplies encrypted by 1 at the scale that makes it target_scale after the
+    rescale.
+    */
+    void correct_scale(seal::Ciphertext &encrypted, double target_scale)
+    {
+        double prime = static_cast<double>(last_prime(encrypted.parms_id()));
+        double plain_scale = target_scale * prime / encrypted.scale();
+        evaluator_.multiply_plain_inplace(encrypted, constants_.get(1, encrypted.parms_id(), plain_scale));
+        rescale(encrypted);
+        stats_.scale_corrections++;
+    }
+
+    void align_for_add(seal::Ciphertext &a, seal::Ciphertext &b)
+    {
+        // SEAL's own scale check: rescaling divides by the prime in floating
+        // point, so equal scales can differ in the last bits
+        if (seal::util::are_close(a.scale(), b.scale()))
+        {
+            align_levels(a, b);
+            return;
+        }
+
+        // the higher one is corrected on its way down; at equal levels both drop one
+        seal::Ciphertext &high = level(a) >= level(b) ? a : b;
+        seal::Ciphertext &low = level(a) >= level(b) ? b : a;
+        if (level(high) == level(low))
+        {
+            auto next_context_data = context_.get_context_data(low.parms_id())->next_context_data();
+            if (!next_context_data)
+            {
+                throw std::logic_error("CKKSScaleManager: no level left to correct the scale");
+            }
+            mod_switch_to(low, next_context_data->parms_id());
+        }
+        correct_scale(high, low.scale());
+        mod_switch_to(high, low.parms_id());
+    }
+
+    const seal::SEALContext &context_;
+
+    const seal::Evaluator &evaluator_;
+
+    CKKSConstantCache &constants_;
+
+    const seal::RelinKeys &relin_keys_;
+
+    op_counts stats_;
+};
@@ -0,0 +1,333 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CKKS_SPECIAL_FFT_X86
+#include <immintrin.h>
+#endif
+
+/*
+The inverse special FFT of CKKS encoding, vectorized with AVX2 / AVX-512.
+
+CKKSEncoder::encode 의 첫 단계 (slot 값 -> 다항식 계수) 를 따로 떼어 낸 것. SEAL 과 같은
+index map 과 root 순서를 쓰고, 실수부 / 허수부를 나눠 저장 (split layout) 해서 butterfly 를
+4개 (AVX2) 또는 8개 (AVX-512) 씩 한 번에 계산한다.
+
+For N = poly_modulus_degree, the N/2 slot values and their conjugates are
+placed at the bit-reversed positions of the powers of 3 mod 2N, as in
+CKKSEncoder, and an inverse negacyclic DWT over the 2N-th roots of unity gives
+the N coefficients, multiplied by scale / N in the last stage. The real parts
+are the coefficients to round; the imaginary parts are zero up to rounding
+error for real inputs.
+
+Each of the log2 N stages combines pairs gap apart with one root per block of
+gap pairs. Stages with gap >= 4 (AVX2) or gap >= 8 (AVX-512) run on whole
+registers with the root broadcast; the first two or three stages, where the
+root changes every one or two pairs, stay scalar. The instruction set is
+picked at run time from what the CPU supports (GCC / Clang on x86), and the
+scalar code is used everywhere else. Every path does the same operations in
+the same order per element; the vector paths fuse the complex products with
+FMA, so coefficients can differ in the last bits, far below the rounding to
+integers that follows.
+*/
+class CKKSSpecialFFT
+{
+public:
+    enum class isa
+    {
+        scalar,
+        avx2,
+        avx512,
+        best
+    };
+
+    CKKSSpecialFFT(std::size_t poly_modulus_degree, isa level = isa::best)
+        : n_(poly_modulus_degree), isa_(level == isa::best ? detect() : level)
+    {
+        if (n_ < 4 || (n_ & (n_ - 1)) != 0)
+        {
+            throw std::invalid_argument("CKKSSpecialFFT: poly_modulus_degree must be a power of two >= 4");
+        }
+        if (isa_ != isa::scalar && !supported(isa_))
+        {
+            throw std::invalid_argument("CKKSSpecialFFT: instruction set not supported by this CPU");
+        }
+
+        int logn = 0;
+        while ((std::size_t(1) << logn) < n_)
+        {
+            logn++;
+        }
+
+        // slot i goes to the position of 3^i mod 2N, its conjugate to -3^i mod 2N
+        const std::size_t m = 2 * n_;
+        const std::size_t slots = n_ / 2;
+        index_map_.resize(n_);
+        std::uint64_t pos = 1;
+        for (std::size_t i = 0; i < slots; i++)
+        {
+            index_map_[i] = reverse_bits((pos - 1) >> 1, logn);
+            index_map_[slots | i] = reverse_bits((m - pos - 1) >> 1, logn);
+            pos = (pos * 3) & (m - 1);
+        }
+
+        // inverse roots in the order the stages consume them, index 0 unused
+        const double pi = std::acos(-1.0);
+        root_re_.resize(n_);
+        root_im_.resize(n_);
+        for (std::size_t i = 1; i < n_; i++)
+        {
+            std::size_t k = reverse_bits(i - 1, logn) + 1;
+            double angle = 2 * pi * static_cast<double>(k) / static_cast<double>(m);
+            root_re_[i] = std::cos(angle);
+            root_im_[i] = -std::sin(angle);
+        }
+    }
+
+    std::size_t coeff_count() const
+    {
+        return n_;
+    }
+
+    isa instruction_set() const
+    {
+        return isa_;
+    }
+
+    static const char *name(isa level)
+    {
+        switch (level)
+        {
+        case isa::avx512:
+            return "AVX-512";
+        case isa::avx2:
+            return "AVX2";
+        default:
+            return "scalar";
+        }
+    }
+
+    static bool supported(isa level)
+    {
+#ifdef CKKS_SPECIAL_FFT_X86
+        switch (level)
+        {
+        case isa::avx512:
+            return __builtin_cpu_supports("avx512f");
+        case isa::avx2:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        default:
+            return true;
+        }
+#else
+        return level == isa::scalar;
+#endif
+    }
+
+    static isa detect()
+    {
+        if (supported(isa::avx512))
+        {
+            return isa::avx512;
+        }
+        return supported(isa::avx2) ? isa::avx2 : isa::scalar;
+    }
+
+    /*
+    re[0, N) = the coefficients of values[0, count) (count <= N/2, the rest
+    of the slots zero) encoded at the given scale, before rounding. im is
+    scratch of the same size. Both must hold N doubles.
+    */
+    void inverse(const double *values, std::size_t count, double scale, double *re, double *im) const
+    {
+        const std::size_t slots = n_ / 2;
+        if (count > slots)
+        {
+            throw std::invalid_argument("CKKSSpecialFFT: more values than slots");
+        }
+        std::fill(re, re + n_, 0.0);
+        std::fill(im, im + n_, 0.0);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            re[index_map_[i]] = values[i];
+            re[index_map_[slots | i]] = values[i];
+        }
+
+        const double fix = scale / static_cast<double>(n_);
+        std::size_t root = 1;
+        std::size_t gap = 1;
+        for (std::size_t m = n_ >> 1; m > 1; m >>= 1, gap <<= 1)
+        {
+            stage(re, im, m, gap, root);
+            root += m;
+        }
+        last_stage(re, im, gap, root, fix);
+    }
+
+private:
+    static std::size_t reverse_bits(std::uint64_t value, int bits)
+    {
+        std::uint64_t result = 0;
+        for (int b = 0; b < bits; b++, value >>= 1)
+        {
+            result = (result << 1) | (value & 1);
+        }
+        return static_cast<std::size_t>(result);
+    }
+
+    // m blocks of gap butterflies: x = u + v, y = (u - v) * root
+    void stage(double *re, double *im, std::size_t m, std::size_t gap, std::size_t root) const
+    {
+#ifdef CKKS_SPECIAL_FFT_X86
+        if (isa_ == isa::avx512 && gap >= 8)
+        {
+            stage_avx512(re, im, m, gap, root);
+            return;
+        }
+        if (isa_ != isa::scalar && gap >= 4)
+        {
+            stage_avx2(re, im, m, gap, root);
+            return;
+        }
+#endif
+        for (std::size_t i = 0, offset = 0; i < m; i++, offset += gap << 1)
+        {
+            const double rr = root_re_[root + i];
+            const double ri = root_im_[root + i];
+            for (std::size_t x = offset, y = offset + gap; x < offset + gap; x++, y++)
+            {
+                double dr = re[x] - re[y];
+                double di = im[x] - im[y];
+                re[x] += re[y];
+                im[x] += im[y];
+                re[y] = dr * rr - di * ri;
+                im[y] = dr * ri + di * rr;
+            }
+        }
+    }
+
+    // the single block of the last stage, scaled by fix
+    void last_stage(double *re, double *im, std::size_t gap, std::size_t root, double fix) const
+    {
+        const double rr = root_re_[root] * fix;
+        const double ri = root_im_[root] * fix;
+#ifdef CKKS_SPECIAL_FFT_X86
+        if (isa_ == isa::avx512 && gap >= 8)
+        {
+            last_stage_avx512(re, im, gap, rr, ri, fix);
+            return;
+        }
+        if (isa_ != isa::scalar && gap >= 4)
+        {
+            last_stage_avx2(re, im, gap, rr, ri, fix);
+            return;
+        }
+#endif
+        for (std::size_t x = 0, y = gap; x < gap; x++, y++)
+        {
+            double dr = re[x] - re[y];
+            double di = im[x] - im[y];
+            re[x] = (re[x] + re[y]) * fix;
+            im[x] = (im[x] + im[y]) * fix;
+            re[y] = dr * rr - di * ri;
+            im[y] = dr * ri + di * rr;
+        }
+    }
+
+#ifdef CKKS_SPECIAL_FFT_X86
+    __attribute__((target("avx2,fma"))) void stage_avx2(
+        double *re, double *im, std::size_t m, std::size_t gap, std::size_t root) const
+    {
+        for (std::size_t i = 0, offset = 0; i < m; i++, offset += gap << 1)
+        {
+            const __m256d rr = _mm256_set1_pd(root_re_[root + i]);
+            const __m256d ri = _mm256_set1_pd(root_im_[root + i]);
+            for (std::size_t x = offset, y = offset + gap; x < offset + gap; x += 4, y += 4)
+            {
+                __m256d ur = _mm256_loadu_pd(re + x), ui = _mm256_loadu_pd(im + x);
+                __m256d vr = _mm256_loadu_pd(re + y), vi = _mm256_loadu_pd(im + y);
+                __m256d dr = _mm256_sub_pd(ur, vr), di = _mm256_sub_pd(ui, vi);
+                _mm256_storeu_pd(re + x, _mm256_add_pd(ur, vr));
+                _mm256_storeu_pd(im + x, _mm256_add_pd(ui, vi));
+                _mm256_storeu_pd(re + y, _mm256_fmsub_pd(dr, rr, _mm256_mul_pd(di, ri)));
+                _mm256_storeu_pd(im + y, _mm256_fmadd_pd(dr, ri, _mm256_mul_pd(di, rr)));
+            }
+        }
+    }
+
+    __attribute__((target("avx2,fma"))) void last_stage_avx2(
+        double *re, double *im, std::size_t gap, double root_re, double root_im, double fix) const
+    {
+        const __m256d rr = _mm256_set1_pd(root_re);
+        const __m256d ri = _mm256_set1_pd(root_im);
+        const __m256d f = _mm256_set1_pd(fix);
+        for (std::size_t x = 0, y = gap; x < gap; x += 4, y += 4)
+        {
+            __m256d ur = _mm256_loadu_pd(re + x), ui = _mm256_loadu_pd(im + x);
+            __m256d vr = _mm256_loadu_pd(re + y), vi = _mm256_loadu_pd(im + y);
+            __m256d dr = _mm256_sub_pd(ur, vr), di = _mm256_sub_pd(ui, vi);
+            _mm256_storeu_pd(re + x, _mm256_mul_pd(_mm256_add_pd(ur, vr), f));
+            _mm256_storeu_pd(im + x, _mm256_mul_pd(_mm256_add_pd(ui, vi), f));
+            _mm256_storeu_pd(re + y, _mm256_fmsub_pd(dr, rr, _mm256_mul_pd(di, ri)));
+            _mm256_storeu_pd(im + y, _mm256_fmadd_pd(dr, ri, _mm256_mul_pd(di, rr)));
+        }
+    }
+
+    __attribute__((target("avx512f"))) void stage_avx512(
+        double *re, double *im, std::size_t m, std::size_t gap, std::size_t root) const
+    {
+        for (std::size_t i = 0, offset = 0; i < m; i++, offset += gap << 1)
+        {
+            const __m512d rr = _mm512_set1_pd(root_re_[root + i]);
+            const __m512d ri = _mm512_set1_pd(root_im_[root + i]);
+            for (std::size_t x = offset, y = offset + gap; x < offset + gap; x += 8, y += 8)
+            {
+                __m512d ur = _mm512_loadu_pd(re + x), ui = _mm512_loadu_pd(im + x);
+                __m512d vr = _mm512_loadu_pd(re + y), vi = _mm512_loadu_pd(im + y);
+                __m512d dr = _mm512_sub_pd(ur, vr), di = _mm512_sub_pd(ui, vi);
+                _mm512_storeu_pd(re + x, _mm512_add_pd(ur, vr));
+                _mm512_storeu_pd(im + x, _mm512_add_pd(ui, vi));
+                _mm512_storeu_pd(re + y, _mm512_fmsub_pd(dr, rr, _mm512_mul_pd(di, ri)));
+                _mm512_storeu_pd(im + y, _mm512_fmadd_pd(dr, ri, _mm512_mul_pd(di, rr)));
+            }
+        }
+    }
+
+    __attribute__((target("avx512f"))) void last_stage_avx512(
+        double *re, double *im, std::size_t gap, double root_re, double root_im, double fix) const
+    {
+        const __m512d rr = _mm512_set1_pd(root_re);
+        const __m512d ri = _mm512_set1_pd(root_im);
+        const __m512d f = _mm512_set1_pd(fix);
+        for (std::size_t x = 0, y = gap; x < gap; x += 8, y += 8)
+        {
+            __m512d ur = _mm512_loadu_pd(re + x), ui = _mm512_loadu_pd(im + x);
+            __m512d vr = _mm512_loadu_pd(re + y), vi = _mm512_loadu_pd(im + y);
+            __m512d dr = _mm512_sub_pd(ur, vr), di = _mm512_sub_pd(ui, vi);
+            _mm512_storeu_pd(re + x, _mm512_mul_pd(_mm512_add_pd(ur, vr), f));
+            _mm512_storeu_pd(im + x, _mm512_mul_pd(_mm512_add_pd(ui, vi), f));
+            _mm512_storeu_pd(re + y, _mm512_fmsub_pd(dr, rr, _mm512_mul_pd(di, ri)));
+            _mm512_storeu_pd(im + y, _mm512_fmadd_pd(dr, ri, _mm512_mul_pd(di, rr)));
+        }
+    }
+#endif
+
+    std::size_t n_;
+
+    isa isa_;
+
+    std::vector<std::size_t> index_map_;
+
+    std::vector<double> root_re_;
+
+    std::vector<double> root_im_;
+};
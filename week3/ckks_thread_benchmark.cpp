@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+/*
+Thread scaling of CKKSParallelDriver, 1 to 64 threads, with the global memory
+pool and with thread-local pools.
+
+9_ckks_task.cpp 와 같은 파라미터로 (x+1)^2(x^2+2) 를 num_inputs 개 입력에 대해 평가하고
+스레드 수 별 처리량 (inputs/s) 과 1 스레드 대비 속도 향상을 출력한다.
+
+usage: ckks_thread_benchmark [num_inputs=256]
+*/
+
+#include "seal/seal.h"
+#include "ckks_parallel_driver.h"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace seal;
+
+double time_run(CKKSParallelDriver &driver, const vector<vector<double>> &inputs, size_t num_threads,
+                bool thread_local_pools)
+{
+    auto time_start = chrono::high_resolution_clock::now();
+    auto results = driver.run(inputs, num_threads, thread_local_pools);
+    auto time_end = chrono::high_resolution_clock::now();
+    return chrono::duration_cast<chrono::microseconds>(time_end - time_start).count() / 1e6;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t num_inputs = argc > 1 ? stoul(argv[1]) : 256;
+
+    EncryptionParameters parms(scheme_type::ckks);
+    size_t poly_modulus_degree = 16384;
+    parms.set_poly_modulus_degree(poly_modulus_degree);
+    parms.set_coeff_modulus(CoeffModulus::Create(poly_modulus_degree, { 60, 50, 50, 50, 50, 60 }));
+    double scale = pow(2.0, 50);
+    SEALContext context(parms);
+
+    KeyGenerator keygen(context);
+    PublicKey public_key;
+    keygen.create_public_key(public_key);
+    RelinKeys relin_keys;
+    keygen.create_relin_keys(relin_keys);
+
+    CKKSParallelDriver driver(context, public_key, relin_keys, scale);
+
+    size_t slot_count = driver.encoder().slot_count();
+    vector<vector<double>> inputs(num_inputs, vector<double>(slot_count));
+    for (size_t i = 0; i < num_inputs; i++)
+    {
+        for (size_t j = 0; j < slot_count; j++)
+        {
+            inputs[i][j] = static_cast<double>((i + j) % slot_count) / slot_count;
+        }
+    }
+
+    // encodes the constants and warms up the pools
+    driver.run(vector<vector<double>>(inputs.begin(), inputs.begin() + 1), 1);
+
+    cout << num_inputs << " inputs, N = " << poly_modulus_degree << ", " << thread::hardware_concurrency()
+         << " hardware threads" << endl;
+    cout << setw(8) << "threads" << setw(16) << "global inputs/s" << setw(10) << "speedup" << setw(20)
+         << "thread-local inp/s" << setw(10) << "speedup" << endl;
+
+    double base_global = 0, base_local = 0;
+    cout << fixed << setprecision(1);
+    for (size_t num_threads = 1; num_threads <= 64; num_threads *= 2)
+    {
+        double global_s = time_run(driver, inputs, num_threads, false);
+        double local_s = time_run(driver, inputs, num_threads, true);
+        if (num_threads == 1)
+        {
+            base_global = global_s;
+            base_local = local_s;
+        }
+        cout << setw(8) << num_threads << setw(16) << num_inputs / global_s << setw(9) << base_global / global_s
+             << "x" << setw(20) << num_inputs / local_s << setw(9) << base_local / local_s << "x" << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,108 @@
+/*
+  Running one circuit over many independent ciphertexts on all cores
+
+  SlotPacker 로 데이터를 꽉 채워 넣으면 서로 독립인 암호문이 여러 개 생긴다. 이것들을 한
+  스레드에서 차례로 돌리지 않고 WorkStealingPool 에 암호문 단위로 나눠서 돌린다.
+ */
+
+#ifndef CAU_PRE_BATCH_EXECUTOR_H
+#define CAU_PRE_BATCH_EXECUTOR_H
+
+#include "openfhe.h"
+#include "circuit.h"
+#include "work-stealing-pool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace lbcrypto {
+
+/**
+ * Throughput of BatchExecutor::Run with one pool configuration
+ */
+struct BatchScalingPoint {
+    uint32_t threads    = 0;  // pool workers
+    uint32_t ompThreads = 0;  // OpenMP threads per worker
+    double ms           = 0;  // the whole batch
+    double throughput   = 0;  // circuit evaluations per second
+    double speedup      = 0;  // against the first point
+    uint64_t steals     = 0;
+
+    friend std::ostream& operator<<(std::ostream& out, const BatchScalingPoint& p) {
+        out << std::setw(3) << p.threads << " workers x " << std::setw(2) << p.ompThreads << " omp: " << std::fixed
+            << std::setprecision(1) << std::setw(9) << p.ms << "ms " << std::setw(8) << p.throughput
+            << " circuits/s speedup=" << std::setprecision(2) << p.speedup << "x steals=" << p.steals
+            << std::defaultfloat;
+        return out;
+    }
+};
+
+/**
+ * @brief BatchExecutor
+ *
+ * Run() evaluates the circuit once per batch element (batch[b] are the
+ * circuit inputs of element b, result[b] its outputs), one pool task per
+ * element. Elements share no ciphertexts, only the context and its keys,
+ * which the operations only read.
+ *
+ * The pool decides how the cores are split between elements and the
+ * OpenMP loops inside each operation (see WorkStealingPool): few large
+ * batches do better with few workers that keep OpenMP, many elements with
+ * one worker per core. ScalingReport() measures this for a batch, from 1
+ * worker (all parallelism inside the operations) up to one worker per
+ * core.
+ */
+class BatchExecutor {
+public:
+    static std::vector<std::vector<Ciphertext<DCRTPoly>>> Run(
+        const CryptoContext<DCRTPoly>& cc, const Circuit& circuit,
+        const std::vector<std::vector<Ciphertext<DCRTPoly>>>& batch, WorkStealingPool& pool) {
+        std::vector<std::vector<Ciphertext<DCRTPoly>>> result(batch.size());
+        for (size_t b = 0; b < batch.size(); b++)
+            pool.Submit([&, b] { result[b] = circuit.Evaluate(cc, batch[b]); });
+        pool.Wait();
+        return result;
+    }
+
+    /**
+   * Times Run() on the batch for every worker count (1, 2, 4, ... up to
+   * the number of cores when threadCounts is empty)
+   */
+    static std::vector<BatchScalingPoint> ScalingReport(const CryptoContext<DCRTPoly>& cc, const Circuit& circuit,
+                                                        const std::vector<std::vector<Ciphertext<DCRTPoly>>>& batch,
+                                                        std::vector<uint32_t> threadCounts = {}) {
+        if (threadCounts.empty()) {
+            uint32_t cores = std::max(1u, std::thread::hardware_concurrency());
+            for (uint32_t t = 1; t < cores; t *= 2)
+                threadCounts.push_back(t);
+            threadCounts.push_back(cores);
+        }
+
+        std::vector<BatchScalingPoint> points;
+        for (uint32_t threads : threadCounts) {
+            WorkStealingPool pool(threads);
+
+            TimeVar t;
+            TIC(t);
+            Run(cc, circuit, batch, pool);
+
+            BatchScalingPoint p;
+            p.ms         = TOC(t);
+            p.threads    = pool.GetNumThreads();
+            p.ompThreads = pool.GetOmpThreadsPerWorker();
+            p.throughput = p.ms > 0 ? batch.size() / p.ms * 1000 : 0;
+            p.speedup    = points.empty() || p.ms == 0 ? 1 : points[0].ms / p.ms;
+            p.steals     = pool.GetSteals();
+            points.push_back(p);
+        }
+        return points;
+    }
+};
+
+}  // namespace lbcrypto
+
+#endif
@@ -0,0 +1,187 @@
+/*
+  Shared measurement fixture for the parameter sweeps
+
+  DnumTuner, DigitSizeTuner, ScalingSweep, ParameterPlanner 와 primitive_benchmark 가 각자
+  Enable / KeyGen / EvalMultKeyGen / EvalRotateKeyGen, 난수 입력 암호화, 시간 측정 반복,
+  Pareto frontier 표시를 복사해서 쓰던 것을 한 곳에 모은 것.
+ */
+
+#ifndef CAU_PRE_BENCH_FIXTURE_H
+#define CAU_PRE_BENCH_FIXTURE_H
+
+#include "openfhe.h"
+#include "circuit.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace lbcrypto {
+
+/**
+ * @brief BenchFixture
+ *
+ * A context ready to be measured: PKE, KEYSWITCH and LEVELEDSHE enabled, a
+ * key pair with its relinearization key and the given rotation keys, and
+ * numInputs vectors of batchSize values drawn uniformly from [-1, 1] with a
+ * fixed seed, so that every configuration of a sweep sees the same inputs.
+ * batchSize 0 means N/2. The evaluation keys are cleared again when the
+ * fixture goes away, so a context shared through the registry does not keep
+ * them.
+ */
+class BenchFixture {
+public:
+    BenchFixture(const CryptoContext<DCRTPoly>& cc, uint32_t numInputs, uint32_t batchSize,
+                 const std::vector<int32_t>& rotIndices = {}, bool encrypt = true)
+        : m_cc(cc) {
+        m_cc->Enable(PKE);
+        m_cc->Enable(KEYSWITCH);
+        m_cc->Enable(LEVELEDSHE);
+
+        m_keys = m_cc->KeyGen();
+        m_cc->EvalMultKeyGen(m_keys.secretKey);
+        if (!rotIndices.empty())
+            m_cc->EvalRotateKeyGen(m_keys.secretKey, rotIndices);
+
+        m_batchSize = batchSize != 0 ? batchSize : m_cc->GetRingDimension() / 2;
+
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<double> dist(-1.0, 1.0);
+        for (uint32_t i = 0; i < numInputs; i++) {
+            std::vector<double> x(m_batchSize);
+            for (auto& v : x)
+                v = dist(gen);
+            m_plainInputs.push_back(x);
+        }
+        if (encrypt)
+            m_inputs = EncryptInputs();
+    }
+
+    ~BenchFixture() {
+        m_cc->ClearEvalMultKeys(m_keys.secretKey->GetKeyTag());
+        m_cc->ClearEvalAutomorphismKeys(m_keys.secretKey->GetKeyTag());
+    }
+
+    BenchFixture(const BenchFixture&)            = delete;
+    BenchFixture& operator=(const BenchFixture&) = delete;
+
+    const CryptoContext<DCRTPoly>& GetContext() const {
+        return m_cc;
+    }
+
+    const KeyPair<DCRTPoly>& GetKeys() const {
+        return m_keys;
+    }
+
+    uint32_t GetBatchSize() const {
+        return m_batchSize;
+    }
+
+    const std::vector<std::vector<double>>& GetPlainInputs() const {
+        return m_plainInputs;
+    }
+
+    // the inputs encrypted once at construction (empty if encrypt was false)
+    const std::vector<Ciphertext<DCRTPoly>>& GetInputs() const {
+        return m_inputs;
+    }
+
+    // fresh encryptions of the inputs
+    std::vector<Ciphertext<DCRTPoly>> EncryptInputs() const {
+        std::vector<Ciphertext<DCRTPoly>> inputs;
+        for (const auto& x : m_plainInputs)
+            inputs.push_back(m_cc->Encrypt(m_keys.publicKey, m_cc->MakeCKKSPackedPlaintext(x)));
+        return inputs;
+    }
+
+    /**
+   * -log2 of the largest error of the decrypted outputs against
+   * Circuit::EvaluatePlain() on the same inputs, 64 if exact
+   */
+    double PrecisionBits(const Circuit& circuit, const std::vector<Plaintext>& results) const {
+        std::vector<std::vector<double>> expected = circuit.EvaluatePlain(m_plainInputs);
+        double maxError                           = 0;
+        for (size_t o = 0; o < results.size(); o++) {
+            results[o]->SetLength(m_batchSize);
+            std::vector<double> values = results[o]->GetRealPackedValue();
+            for (size_t j = 0; j < m_batchSize && j < values.size(); j++)
+                maxError = std::max(maxError, std::abs(values[j] - expected[o][j]));
+        }
+        return maxError > 0 ? -std::log2(maxError) : 64;
+    }
+
+    double PrecisionBits(const Circuit& circuit, const std::vector<Ciphertext<DCRTPoly>>& outputs) const {
+        std::vector<Plaintext> results(outputs.size());
+        for (size_t o = 0; o < outputs.size(); o++)
+            m_cc->Decrypt(m_keys.secretKey, outputs[o], &results[o]);
+        return PrecisionBits(circuit, results);
+    }
+
+    /**
+   * Average time (ms) of numRuns calls of f
+   */
+    template <typename F>
+    static double TimeMs(uint32_t numRuns, F&& f) {
+        TimeVar t;
+        TIC(t);
+        for (uint32_t r = 0; r < numRuns; r++)
+            f();
+        return TOC(t) / numRuns;
+    }
+
+    /**
+   * Sets p.pareto on every point no other point dominates. costs(p) lists
+   * the objectives of p, all to be minimized (negate the ones to maximize);
+   * q dominates p if it is no worse in all of them and better in one.
+   */
+    template <typename Point, typename Costs>
+    static void MarkPareto(std::vector<Point>& points, Costs costs) {
+        std::vector<std::vector<double>> values;
+        for (const auto& p : points)
+            values.push_back(costs(p));
+
+        for (size_t i = 0; i < points.size(); i++) {
+            points[i].pareto = true;
+            for (size_t j = 0; j < points.size() && points[i].pareto; j++) {
+                bool noWorse = true, better = false;
+                for (size_t k = 0; k < values[i].size(); k++) {
+                    noWorse = noWorse && values[j][k] <= values[i][k];
+                    better  = better || values[j][k] < values[i][k];
+                }
+                if (noWorse && better)
+                    points[i].pareto = false;
+            }
+        }
+    }
+
+    static std::string ToString(ScalingTechnique scalTech) {
+        switch (scalTech) {
+            case FLEXIBLEAUTO:
+                return "FLEXIBLEAUTO";
+            case FIXEDAUTO:
+                return "FIXEDAUTO";
+            case FIXEDMANUAL:
+                return "FIXEDMANUAL";
+            default:
+                return "OTHER";
+        }
+    }
+
+    static std::string ToString(KeySwitchTechnique ksTech) {
+        return ksTech == HYBRID ? "HYBRID" : "BV";
+    }
+
+private:
+    CryptoContext<DCRTPoly> m_cc;
+    KeyPair<DCRTPoly> m_keys;
+    uint32_t m_batchSize = 0;
+    std::vector<std::vector<double>> m_plainInputs;
+    std::vector<Ciphertext<DCRTPoly>> m_inputs;
+};
+
+}  // namespace lbcrypto
+
+#endif
@@ -0,0 +1,109 @@
+/*
+  Compares two primitive_benchmark results and flags regressions
+
+  이전에 저장해 둔 결과 (baseline) 와 새 결과를 benchmark 이름별로 비교한다.
+  평균이 threshold % 이상, 그리고 baseline 표준편차의 2배 이상 느려지면 regression.
+  중앙값 (p50) 은 outlier 확인용으로 같이 출력한다.
+
+  usage: benchmark_compare baseline.json current.json [threshold_percent=10]
+  exit code: 0 if no regression, 1 otherwise
+ */
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+struct Entry {
+    double mean   = 0;
+    double stddev = 0;
+    double p50    = 0;
+};
+
+// primitive_benchmark writes one benchmark object per line
+std::string StringField(const std::string& line, const std::string& key) {
+    std::string pattern = "\"" + key + "\": \"";
+    size_t begin        = line.find(pattern);
+    if (begin == std::string::npos)
+        return "";
+    begin += pattern.size();
+    return line.substr(begin, line.find('"', begin) - begin);
+}
+
+double NumberField(const std::string& line, const std::string& key) {
+    std::string pattern = "\"" + key + "\": ";
+    size_t begin        = line.find(pattern);
+    if (begin == std::string::npos)
+        return 0;
+    return std::stod(line.substr(begin + pattern.size()));
+}
+
+std::map<std::string, Entry> Load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in)
+        throw std::runtime_error("cannot open " + path);
+
+    std::map<std::string, Entry> entries;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::string name = StringField(line, "name");
+        if (name.empty())
+            continue;
+        Entry e;
+        e.mean        = NumberField(line, "mean_us");
+        e.stddev      = NumberField(line, "stddev_us");
+        e.p50         = NumberField(line, "p50_us");
+        entries[name] = e;
+    }
+    return entries;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " baseline.json current.json [threshold_percent=10]" << std::endl;
+        return 2;
+    }
+    double threshold = argc > 3 ? std::stod(argv[3]) : 10.0;
+
+    std::map<std::string, Entry> baseline, current;
+    try {
+        baseline = Load(argv[1]);
+        current  = Load(argv[2]);
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+
+    size_t regressions = 0;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto& entry : current) {
+        auto it = baseline.find(entry.first);
+        if (it == baseline.end()) {
+            std::cout << "  new         " << entry.first << ": " << entry.second.mean << " us, p50 "
+                      << entry.second.p50 << " us" << std::endl;
+            continue;
+        }
+
+        const Entry& before = it->second;
+        const Entry& after  = entry.second;
+        double change       = (after.mean - before.mean) / before.mean * 100;
+        bool regression     = change > threshold && after.mean - before.mean > 2 * before.stddev;
+        bool improvement    = change < -threshold && before.mean - after.mean > 2 * before.stddev;
+        regressions += regression;
+
+        std::cout << (regression ? "  REGRESSION  " : improvement ? "  faster      " : "  ok          ")
+                  << entry.first << ": " << before.mean << " -> " << after.mean << " us ("
+                  << std::showpos << change << std::noshowpos << "%), p50 " << before.p50 << " -> " << after.p50
+                  << " us" << std::endl;
+    }
+    for (const auto& entry : baseline)
+        if (current.find(entry.first) == current.end())
+            std::cout << "  missing     " << entry.first << std::endl;
+
+    std::cout << regressions << " regression(s) above " << threshold << "%" << std::endl;
+    return regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,381 @@
+/*
+  Recorded homomorphic circuits
+
+  연산을 바로 실행하지 않고 DAG 로 기록해 두었다가 분석 (depth, 연산 수, 필요한 rotation)
+  하거나 CryptoContext 위에서 실행하기 위한 클래스.
+ */
+
+#ifndef CAU_PRE_CIRCUIT_H
+#define CAU_PRE_CIRCUIT_H
+
+#include "openfhe.h"
+#include "poly-eval.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace lbcrypto {
+
+enum class CircuitOp {
+    INPUT,
+    ADD,            // ct + ct
+    SUB,            // ct - ct
+    ADD_CONST,      // ct + constant
+    MULT,           // ct * ct (relinearized)
+    MULT_CONST,     // ct * constant
+    SQUARE,         // ct * ct with the same input
+    ROTATE,         // EvalRotate(ct, index)
+    RESCALE,        // explicit Rescale, only meaningful for FIXEDMANUAL
+    MULT_NO_RELIN,  // ct * ct without relinearization (3 elements)
+    RELINEARIZE,    // back to 2 elements
+};
+
+struct CircuitNode {
+    CircuitOp op;
+    std::vector<uint32_t> inputs;
+    double constant = 0.0;  // ADD_CONST, MULT_CONST
+    int32_t index   = 0;    // ROTATE
+};
+
+/**
+ * Number of operations of each kind in a circuit
+ */
+struct CircuitCounts {
+    uint32_t adds             = 0;  // ADD, SUB, ADD_CONST
+    uint32_t mults            = 0;  // MULT, SQUARE, MULT_NO_RELIN
+    uint32_t scalarMults      = 0;  // MULT_CONST
+    uint32_t rotations        = 0;
+    uint32_t rescales         = 0;  // explicit RESCALE nodes
+    uint32_t relinearizations = 0;  // MULT, SQUARE and RELINEARIZE nodes
+
+    // every relinearization and every rotation is one key switch
+    uint32_t KeySwitches() const {
+        return relinearizations + rotations;
+    }
+};
+
+/**
+ * @brief Circuit
+ *
+ * A DAG of CKKS operations. Nodes are appended in topological order, and a
+ * Wire is the index of the node producing a value.
+ *
+ *   Circuit circuit;
+ *   auto x  = circuit.Input();
+ *   auto x1 = circuit.AddConst(x, 1.0);
+ *   circuit.Output(circuit.Mult(circuit.Square(x1), circuit.AddConst(circuit.Square(x), 2.0)));
+ */
+class Circuit {
+public:
+    using Wire = uint32_t;
+
+    Wire Input() {
+        m_numInputs++;
+        return Append({CircuitOp::INPUT, {}});
+    }
+    Wire Add(Wire a, Wire b) {
+        return Append({CircuitOp::ADD, {a, b}});
+    }
+    Wire Sub(Wire a, Wire b) {
+        return Append({CircuitOp::SUB, {a, b}});
+    }
+    Wire AddConst(Wire a, double c) {
+        return Append({CircuitOp::ADD_CONST, {a}, c});
+    }
+    Wire Mult(Wire a, Wire b) {
+        return Append({CircuitOp::MULT, {a, b}});
+    }
+    Wire MultConst(Wire a, double c) {
+        return Append({CircuitOp::MULT_CONST, {a}, c});
+    }
+    Wire Square(Wire a) {
+        return Append({CircuitOp::SQUARE, {a}});
+    }
+    Wire Rotate(Wire a, int32_t index) {
+        return Append({CircuitOp::ROTATE, {a}, 0.0, index});
+    }
+    Wire Rescale(Wire a) {
+        return Append({CircuitOp::RESCALE, {a}});
+    }
+    Wire MultNoRelin(Wire a, Wire b) {
+        return Append({CircuitOp::MULT_NO_RELIN, {a, b}});
+    }
+    Wire Relinearize(Wire a) {
+        return Append({CircuitOp::RELINEARIZE, {a}});
+    }
+
+    /**
+   * Records p(x) = c[0] + ... + c[d] x^d with the PolyEvaluator schedule
+   */
+    Wire Polynomial(Wire x, const std::vector<double>& coefficients, uint32_t extraDepth = 0) {
+        RecordBackend backend{*this, x};
+        return PolyEvaluator::EvalWithBackend(backend, coefficients, extraDepth);
+    }
+
+    void Output(Wire w) {
+        m_outputs.push_back(w);
+    }
+
+    const std::vector<CircuitNode>& GetNodes() const {
+        return m_nodes;
+    }
+    const std::vector<Wire>& GetOutputs() const {
+        return m_outputs;
+    }
+    uint32_t GetNumInputs() const {
+        return m_numInputs;
+    }
+
+    /**
+   * Number of batch slots the circuit works on; used when the circuit
+   * parameters are derived from the circuit itself.
+   */
+    uint32_t GetSlots() const {
+        return m_slots;
+    }
+    void SetSlots(uint32_t slots) {
+        m_slots = slots;
+    }
+
+    /**
+   * Level of every node with automatic rescaling (FLEXIBLEAUTO/FIXEDAUTO):
+   * every MULT, MULT_NO_RELIN, SQUARE and MULT_CONST consumes one level, and
+   * explicit RESCALE nodes are ignored.
+   */
+    std::vector<uint32_t> GetLevels() const {
+        std::vector<uint32_t> levels(m_nodes.size(), 0);
+        for (size_t i = 0; i < m_nodes.size(); i++) {
+            uint32_t level = 0;
+            for (Wire in : m_nodes[i].inputs)
+                level = std::max(level, levels[in]);
+            if (ConsumesLevel(m_nodes[i].op))
+                level++;
+            levels[i] = level;
+        }
+        return levels;
+    }
+
+    /**
+   * Multiplicative depth of the circuit (the value to pass to
+   * SetMultiplicativeDepth)
+   */
+    uint32_t GetDepth() const {
+        std::vector<uint32_t> levels = GetLevels();
+        uint32_t depth               = 0;
+        for (Wire w : m_outputs)
+            depth = std::max(depth, levels[w]);
+        return depth;
+    }
+
+    CircuitCounts GetCounts() const {
+        CircuitCounts counts;
+        for (const auto& node : m_nodes) {
+            switch (node.op) {
+                case CircuitOp::ADD:
+                case CircuitOp::SUB:
+                case CircuitOp::ADD_CONST:
+                    counts.adds++;
+                    break;
+                case CircuitOp::MULT:
+                case CircuitOp::SQUARE:
+                    counts.mults++;
+                    counts.relinearizations++;
+                    break;
+                case CircuitOp::MULT_NO_RELIN:
+                    counts.mults++;
+                    break;
+                case CircuitOp::RELINEARIZE:
+                    counts.relinearizations++;
+                    break;
+                case CircuitOp::MULT_CONST:
+                    counts.scalarMults++;
+                    break;
+                case CircuitOp::ROTATE:
+                    counts.rotations++;
+                    break;
+                case CircuitOp::RESCALE:
+                    counts.rescales++;
+                    break;
+                default:
+                    break;
+            }
+        }
+        return counts;
+    }
+
+    /**
+   * Rotation indices used by the circuit (the list to pass to EvalRotateKeyGen)
+   */
+    std::vector<int32_t> GetRotationIndices() const {
+        std::set<int32_t> indices;
+        for (const auto& node : m_nodes)
+            if (node.op == CircuitOp::ROTATE)
+                indices.insert(node.index);
+        return std::vector<int32_t>(indices.begin(), indices.end());
+    }
+
+    /**
+   * Runs the circuit on the given input ciphertexts (one per Input(), in
+   * order) and returns the outputs (one per Output(), in order).
+   */
+    std::vector<Ciphertext<DCRTPoly>> Evaluate(const CryptoContext<DCRTPoly>& cc,
+                                               const std::vector<Ciphertext<DCRTPoly>>& inputs) const {
+        if (inputs.size() != m_numInputs)
+            OPENFHE_THROW(config_error, "Circuit::Evaluate: expected " + std::to_string(m_numInputs) + " inputs, got " +
+                                            std::to_string(inputs.size()));
+
+        std::vector<Ciphertext<DCRTPoly>> values(m_nodes.size());
+        size_t nextInput = 0;
+        for (size_t i = 0; i < m_nodes.size(); i++)
+            values[i] = EvaluateNode(cc, m_nodes[i], values, inputs, nextInput);
+
+        std::vector<Ciphertext<DCRTPoly>> outputs;
+        for (Wire w : m_outputs)
+            outputs.push_back(values[w]);
+        return outputs;
+    }
+
+    /**
+   * Runs the circuit on cleartext vectors (all of the same length, one per
+   * Input()); the reference for measuring the precision of Evaluate().
+   * ROTATE is cyclic over the length of the vectors.
+   */
+    std::vector<std::vector<double>> EvaluatePlain(const std::vector<std::vector<double>>& inputs) const {
+        if (inputs.size() != m_numInputs)
+            OPENFHE_THROW(config_error, "Circuit::EvaluatePlain: expected " + std::to_string(m_numInputs) +
+                                            " inputs, got " + std::to_string(inputs.size()));
+
+        std::vector<std::vector<double>> values(m_nodes.size());
+        size_t nextInput = 0;
+        for (size_t i = 0; i < m_nodes.size(); i++) {
+            const CircuitNode& node = m_nodes[i];
+            if (node.op == CircuitOp::INPUT) {
+                values[i] = inputs[nextInput++];
+                continue;
+            }
+
+            const std::vector<double>& a = values[node.inputs[0]];
+            const std::vector<double>& b = values[node.inputs.size() > 1 ? node.inputs[1] : node.inputs[0]];
+            std::vector<double> v(a.size());
+            for (size_t j = 0; j < a.size(); j++) {
+                switch (node.op) {
+                    case CircuitOp::ADD:
+                        v[j] = a[j] + b[j];
+                        break;
+                    case CircuitOp::SUB:
+                        v[j] = a[j] - b[j];
+                        break;
+                    case CircuitOp::ADD_CONST:
+                        v[j] = a[j] + node.constant;
+                        break;
+                    case CircuitOp::MULT:
+                    case CircuitOp::MULT_NO_RELIN:
+                    case CircuitOp::SQUARE:
+                        v[j] = a[j] * b[j];
+                        break;
+                    case CircuitOp::MULT_CONST:
+                        v[j] = a[j] * node.constant;
+                        break;
+                    case CircuitOp::ROTATE: {
+                        int64_t n = static_cast<int64_t>(a.size());
+                        v[j]      = a[((static_cast<int64_t>(j) + node.index) % n + n) % n];
+                        break;
+                    }
+                    default:  // RESCALE, RELINEARIZE
+                        v[j] = a[j];
+                        break;
+                }
+            }
+            values[i] = std::move(v);
+        }
+
+        std::vector<std::vector<double>> outputs;
+        for (Wire w : m_outputs)
+            outputs.push_back(values[w]);
+        return outputs;
+    }
+
+    /**
+   * Runs a single node given the values of its inputs; INPUT nodes take the
+   * next ciphertext from inputs. Shared by Evaluate() and the schedulers.
+   */
+    static Ciphertext<DCRTPoly> EvaluateNode(const CryptoContext<DCRTPoly>& cc, const CircuitNode& node,
+                                             const std::vector<Ciphertext<DCRTPoly>>& values,
+                                             const std::vector<Ciphertext<DCRTPoly>>& inputs, size_t& nextInput) {
+        switch (node.op) {
+            case CircuitOp::INPUT:
+                return inputs[nextInput++];
+            case CircuitOp::ADD:
+                return cc->EvalAdd(values[node.inputs[0]], values[node.inputs[1]]);
+            case CircuitOp::SUB:
+                return cc->EvalSub(values[node.inputs[0]], values[node.inputs[1]]);
+            case CircuitOp::ADD_CONST:
+                return cc->EvalAdd(values[node.inputs[0]], node.constant);
+            case CircuitOp::MULT:
+                return cc->EvalMult(values[node.inputs[0]], values[node.inputs[1]]);
+            case CircuitOp::MULT_CONST:
+                return cc->EvalMult(values[node.inputs[0]], node.constant);
+            case CircuitOp::SQUARE:
+                return cc->EvalSquare(values[node.inputs[0]]);
+            case CircuitOp::ROTATE:
+                return cc->EvalRotate(values[node.inputs[0]], node.index);
+            case CircuitOp::RESCALE:
+                return cc->Rescale(values[node.inputs[0]]);
+            case CircuitOp::MULT_NO_RELIN:
+                return cc->EvalMultNoRelin(values[node.inputs[0]], values[node.inputs[1]]);
+            case CircuitOp::RELINEARIZE:
+                return cc->Relinearize(values[node.inputs[0]]);
+        }
+        OPENFHE_THROW(config_error, "Circuit: unknown operation");
+    }
+
+    static bool ConsumesLevel(CircuitOp op) {
+        return op == CircuitOp::MULT || op == CircuitOp::SQUARE || op == CircuitOp::MULT_CONST ||
+               op == CircuitOp::MULT_NO_RELIN;
+    }
+
+private:
+    // lets PolyEvaluator record its schedule into the circuit
+    struct RecordBackend {
+        using Value = Wire;
+
+        Circuit& circuit;
+        Wire x;
+
+        Value Input() {
+            return x;
+        }
+        Value Mult(const Value& a, const Value& b) {
+            return a == b ? circuit.Square(a) : circuit.Mult(a, b);
+        }
+        Value MultConst(const Value& a, double c) {
+            return circuit.MultConst(a, c);
+        }
+        Value Add(const Value& a, const Value& b) {
+            return circuit.Add(a, b);
+        }
+        Value AddConst(const Value& a, double c) {
+            return circuit.AddConst(a, c);
+        }
+    };
+
+    Wire Append(CircuitNode node) {
+        for (Wire in : node.inputs)
+            if (in >= m_nodes.size())
+                OPENFHE_THROW(config_error, "Circuit: input wire " + std::to_string(in) + " does not exist yet");
+        m_nodes.push_back(std::move(node));
+        return m_nodes.size() - 1;
+    }
+
+    std::vector<CircuitNode> m_nodes;
+    std::vector<Wire> m_outputs;
+    uint32_t m_numInputs = 0;
+    uint32_t m_slots     = 8;
+};
+
+}  // namespace lbcrypto
+
+#endif
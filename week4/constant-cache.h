@@ -0,0 +1,135 @@
+/*
+  Per-level cache of encoded CKKS constants
+
+  상수를 plaintext 로 쓸 때마다 MakeCKKSPackedPlaintext 로 다시 encode 하지 않고,
+  (값, level, scaling degree) 별로 한 번만 encode 해서 재사용한다.
+ */
+
+#ifndef CAU_PRE_CONSTANT_CACHE_H
+#define CAU_PRE_CONSTANT_CACHE_H
+
+#include "openfhe.h"
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace lbcrypto {
+
+/**
+ * @brief ConstantCache
+ *
+ * Keeps constant vectors encoded as CKKS plaintexts for one CryptoContext,
+ * keyed by (values, level, noise scale degree). The level and degree fix the
+ * scaling factor of the plaintext, so a cached plaintext matches the ciphertext
+ * it is combined with exactly and is already in EVALUATION (NTT) form; a hit
+ * costs one map lookup instead of an encode.
+ *
+ * EvalAdd(ct, double) and EvalMult(ct, double) of OpenFHE work on the scaled
+ * integer directly and never encode; the cache is meant for constants that
+ * are plaintexts anyway (per-slot constants, masks, polynomial coefficients
+ * given as vectors) and that are used again and again across evaluations.
+ *
+ * The cache can be shared between threads.
+ */
+class ConstantCache {
+public:
+    explicit ConstantCache(const CryptoContext<DCRTPoly>& cc) : m_cc(cc) {
+        m_slots = cc->GetEncodingParams()->GetBatchSize();
+        if (m_slots == 0)
+            m_slots = cc->GetRingDimension() / 2;
+    }
+
+    /**
+   * values encoded at the given level and noise scale degree, encoded on the
+   * first request only
+   */
+    Plaintext Get(const std::vector<double>& values, uint32_t level, size_t noiseScaleDeg = 1) {
+        Key key{values, level, noiseScaleDeg};
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_cache.find(key);
+        if (it != m_cache.end()) {
+            m_hits++;
+            return it->second;
+        }
+
+        m_misses++;
+        Plaintext ptxt = m_cc->MakeCKKSPackedPlaintext(values, noiseScaleDeg, level);
+        m_cache.emplace(std::move(key), ptxt);
+        return ptxt;
+    }
+
+    /**
+   * value in every slot
+   */
+    Plaintext Get(double value, uint32_t level, size_t noiseScaleDeg = 1) {
+        return Get(std::vector<double>(m_slots, value), level, noiseScaleDeg);
+    }
+
+    /**
+   * ct + values, with values encoded at the level and degree of ct
+   */
+    Ciphertext<DCRTPoly> EvalAdd(ConstCiphertext<DCRTPoly> ct, const std::vector<double>& values) {
+        return m_cc->EvalAdd(ct, Get(values, ct->GetLevel(), ct->GetNoiseScaleDeg()));
+    }
+    Ciphertext<DCRTPoly> EvalAdd(ConstCiphertext<DCRTPoly> ct, double value) {
+        return EvalAdd(ct, std::vector<double>(m_slots, value));
+    }
+
+    /**
+   * ct * values. With FLEXIBLEAUTO/FIXEDAUTO, OpenFHE rescales ct first if
+   * it has not been rescaled yet, so values are encoded at the level ct will
+   * have then.
+   */
+    Ciphertext<DCRTPoly> EvalMult(ConstCiphertext<DCRTPoly> ct, const std::vector<double>& values) {
+        uint32_t level = ct->GetLevel();
+        size_t degree  = ct->GetNoiseScaleDeg();
+        if (!ManualRescale() && degree > 1)
+            level += degree - 1;
+        return m_cc->EvalMult(ct, Get(values, level, 1));
+    }
+    Ciphertext<DCRTPoly> EvalMult(ConstCiphertext<DCRTPoly> ct, double value) {
+        return EvalMult(ct, std::vector<double>(m_slots, value));
+    }
+
+    void Clear() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cache.clear();
+    }
+
+    size_t Size() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_cache.size();
+    }
+    size_t Hits() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_hits;
+    }
+    size_t Misses() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_misses;
+    }
+
+private:
+    using Key = std::tuple<std::vector<double>, uint32_t, size_t>;
+
+    bool ManualRescale() const {
+        const auto cryptoParams = std::dynamic_pointer_cast<CryptoParametersRNS>(m_cc->GetCryptoParameters());
+        return cryptoParams && cryptoParams->GetScalingTechnique() == FIXEDMANUAL;
+    }
+
+    CryptoContext<DCRTPoly> m_cc;
+    uint32_t m_slots = 0;
+
+    mutable std::mutex m_mutex;
+    std::map<Key, Plaintext> m_cache;
+    size_t m_hits   = 0;
+    size_t m_misses = 0;
+};
+
+}  // namespace lbcrypto
+
+#endif
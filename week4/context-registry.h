@@ -0,0 +1,168 @@
+/*
+  One shared CryptoContext per parameter set
+
+  week4_task 의 ManualRescaleDemo, ConstantCacheDemo, InnerProductDemo 는 똑같은 파라미터로
+  GenCryptoContext 를 각자 부른다. 파라미터를 정규화한 문자열을 key 로 context 를 한 번만 만들고,
+  같은 파라미터를 요청하는 곳에는 그 context 를 돌려준다.
+ */
+
+#ifndef CAU_PRE_CONTEXT_REGISTRY_H
+#define CAU_PRE_CONTEXT_REGISTRY_H
+
+#include "openfhe.h"
+
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef __linux__
+    #include <unistd.h>
+#endif
+
+namespace lbcrypto {
+
+/**
+ * N identical context requests, served by GenCryptoContext and by ContextRegistry
+ */
+struct ContextSharingReport {
+    uint32_t requests       = 0;
+    double separateMs       = 0;  // N x GenCryptoContext
+    double sharedMs         = 0;  // N x ContextRegistry::Get
+    size_t separateContexts = 0;  // distinct objects returned
+    size_t sharedContexts   = 0;
+    long separateBytes      = 0;  // resident memory growth, 0 where it cannot be read
+    long sharedBytes        = 0;
+
+    friend std::ostream& operator<<(std::ostream& out, const ContextSharingReport& r) {
+        out << r.requests << " requests: GenCryptoContext " << std::fixed << std::setprecision(1) << r.separateMs
+            << "ms, " << r.separateContexts << " contexts, +" << r.separateBytes / double(1 << 20)
+            << "MB | registry " << r.sharedMs << "ms, " << r.sharedContexts << " contexts, +"
+            << r.sharedBytes / double(1 << 20) << "MB" << std::defaultfloat;
+        return out;
+    }
+};
+
+/**
+ * @brief ContextRegistry
+ *
+ * Process-wide map from a canonical form of CCParams to the CryptoContext
+ * generated for it. The canonical form is the text CCParams prints, which
+ * lists every parameter in a fixed order, so two CCParams built in
+ * different orders or in different places map to the same entry, and any
+ * parameter that differs gives a different one. Get() generates the context
+ * on the first request and returns the same object afterwards; concurrent
+ * first requests for the same parameters wait for one generation, requests
+ * for other parameters do not wait for it.
+ *
+ * OpenFHE's own factory also returns an existing context when an equal one
+ * is alive, but only at the end of GenCryptoContext, after the moduli and
+ * the CRT and NTT precomputations have been generated again. Get() skips
+ * all of that. The features enabled with Enable() and the evaluation keys
+ * (stored per secret key tag) are shared along with the context, which is
+ * what every demo here expects.
+ */
+class ContextRegistry {
+public:
+    static CryptoContext<DCRTPoly> Get(const CCParams<CryptoContextCKKSRNS>& parameters) {
+        std::shared_ptr<Entry> entry;
+        {
+            std::lock_guard<std::mutex> lock(Mutex());
+            auto& slot = Entries()[CanonicalKey(parameters)];
+            if (!slot)
+                slot = std::make_shared<Entry>();
+            entry = slot;
+        }
+        // a throwing GenCryptoContext leaves the flag unset, so the next Get() retries
+        std::call_once(entry->once, [&] { entry->cc = GenCryptoContext(parameters); });
+        return entry->cc;
+    }
+
+    static std::string CanonicalKey(const CCParams<CryptoContextCKKSRNS>& parameters) {
+        std::ostringstream key;
+        key << parameters;
+        return key.str();
+    }
+
+    // parameter sets requested so far
+    static size_t Size() {
+        std::lock_guard<std::mutex> lock(Mutex());
+        return Entries().size();
+    }
+
+    /**
+   * Forgets every context; the ones still referenced elsewhere stay alive
+   */
+    static void Clear() {
+        std::lock_guard<std::mutex> lock(Mutex());
+        Entries().clear();
+    }
+
+    /**
+   * Serves `requests` identical requests first with GenCryptoContext, then
+   * with Get(), keeping every returned context alive until the end of each
+   * run
+   */
+    static ContextSharingReport Measure(const CCParams<CryptoContextCKKSRNS>& parameters, uint32_t requests) {
+        ContextSharingReport r;
+        r.requests = requests;
+        TimeVar t;
+
+        std::vector<CryptoContext<DCRTPoly>> contexts;
+        long before = ResidentBytes();
+        TIC(t);
+        for (uint32_t i = 0; i < requests; i++)
+            contexts.push_back(GenCryptoContext(parameters));
+        r.separateMs       = TOC(t);
+        r.separateBytes    = ResidentBytes() - before;
+        r.separateContexts = std::set<CryptoContext<DCRTPoly>>(contexts.begin(), contexts.end()).size();
+        contexts.clear();
+
+        before = ResidentBytes();
+        TIC(t);
+        for (uint32_t i = 0; i < requests; i++)
+            contexts.push_back(Get(parameters));
+        r.sharedMs       = TOC(t);
+        r.sharedBytes    = ResidentBytes() - before;
+        r.sharedContexts = std::set<CryptoContext<DCRTPoly>>(contexts.begin(), contexts.end()).size();
+        return r;
+    }
+
+private:
+    struct Entry {
+        std::once_flag once;
+        CryptoContext<DCRTPoly> cc;
+    };
+
+    static std::unordered_map<std::string, std::shared_ptr<Entry>>& Entries() {
+        static std::unordered_map<std::string, std::shared_ptr<Entry>> entries;
+        return entries;
+    }
+
+    static std::mutex& Mutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    // resident set size from /proc (Linux only)
+    static long ResidentBytes() {
+#ifdef __linux__
+        std::ifstream statm("/proc/self/statm");
+        long size = 0, resident = 0;
+        if (statm >> size >> resident)
+            return resident * sysconf(_SC_PAGESIZE);
+#endif
+        return 0;
+    }
+};
+
+}  // namespace lbcrypto
+
+#endif
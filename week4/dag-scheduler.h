@@ -0,0 +1,243 @@
+/*
+  Running the independent nodes of a circuit concurrently
+
+  AutomaticRescaleDemo 의 (x+1)^2 와 x^2+2 처럼 서로 의존하지 않는 부분을 차례로 돌리지 않고,
+  Circuit 의 DAG 에서 입력이 준비된 node 들을 WorkStealingPool 에서 동시에 실행한다.
+  critical path 가 긴 node 를 먼저 돌리고, 살아 있는 중간 암호문 수에 상한을 둘 수 있다.
+ */
+
+#ifndef CAU_PRE_DAG_SCHEDULER_H
+#define CAU_PRE_DAG_SCHEDULER_H
+
+#include "openfhe.h"
+#include "circuit.h"
+#include "work-stealing-pool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace lbcrypto {
+
+/**
+ * What one DagScheduler::Evaluate call did
+ */
+struct DagScheduleStats {
+    double ms            = 0;
+    uint32_t nodes       = 0;  // nodes run as pool tasks (all but INPUT)
+    uint32_t maxRunning  = 0;  // most nodes running at the same time
+    uint32_t maxLive     = 0;  // most intermediate ciphertexts alive at the same time
+    uint32_t memoryWaits = 0;  // times a ready node had to wait for the memory cap
+    uint64_t steals      = 0;
+
+    friend std::ostream& operator<<(std::ostream& out, const DagScheduleStats& s) {
+        out << std::fixed << std::setprecision(3) << s.ms << "ms, " << s.nodes << " nodes, max running "
+            << s.maxRunning << ", max live " << s.maxLive << ", memory waits " << s.memoryWaits << ", steals "
+            << s.steals << std::defaultfloat;
+        return out;
+    }
+};
+
+/**
+ * @brief DagScheduler
+ *
+ * Evaluate() gives the same outputs as Circuit::Evaluate(), running every
+ * node through Circuit::EvaluateNode() as soon as its inputs are done:
+ *
+ * - Ready nodes wait in a priority queue ordered by the cost of the longest
+ *   path from the node to an output (see NodeCost), so the chain that
+ *   bounds the latency starts first. At most one node per pool worker is
+ *   handed to the pool at a time; the pool's own deques therefore never
+ *   hold a backlog that would bypass the priorities.
+ * - An intermediate ciphertext is released as soon as its last consumer has
+ *   finished (outputs are kept). With maxLive > 0 a node only starts when
+ *   the ciphertexts alive, counting the ones the running nodes are
+ *   producing, stay within maxLive; when nothing is running the next node
+ *   starts regardless, so a cap below the circuit's minimum still finishes,
+ *   just serially.
+ *
+ * Input ciphertexts belong to the caller and are not counted. Only circuits
+ * that are wide somewhere (independent subcomputations) get faster; a chain
+ * of dependent operations runs at the speed of Circuit::Evaluate().
+ */
+class DagScheduler {
+public:
+    explicit DagScheduler(WorkStealingPool& pool, uint32_t maxLive = 0) : m_pool(pool), m_maxLive(maxLive) {}
+
+    std::vector<Ciphertext<DCRTPoly>> Evaluate(const CryptoContext<DCRTPoly>& cc, const Circuit& circuit,
+                                               const std::vector<Ciphertext<DCRTPoly>>& inputs,
+                                               DagScheduleStats* stats = nullptr) {
+        const auto& nodes = circuit.GetNodes();
+        if (inputs.size() != circuit.GetNumInputs())
+            OPENFHE_THROW(config_error, "DagScheduler: expected " + std::to_string(circuit.GetNumInputs()) +
+                                            " inputs, got " + std::to_string(inputs.size()));
+
+        TimeVar t;
+        TIC(t);
+        const uint64_t stealsBefore = m_pool.GetSteals();
+
+        Run run(nodes.size());
+        run.priority = CriticalPath(circuit);
+        for (Circuit::Wire w : circuit.GetOutputs())
+            run.isOutput[w] = true;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            for (Circuit::Wire in : nodes[i].inputs) {
+                run.consumers[in].push_back(static_cast<uint32_t>(i));
+                run.uses[in]++;
+            }
+            run.waitingFor[i] = static_cast<uint32_t>(nodes[i].inputs.size());
+        }
+
+        // INPUT nodes are just the caller's ciphertexts
+        size_t nextInput = 0;
+        {
+            std::lock_guard<std::mutex> lock(run.mutex);
+            for (size_t i = 0; i < nodes.size(); i++) {
+                if (nodes[i].op != CircuitOp::INPUT)
+                    continue;
+                run.values[i]  = inputs[nextInput++];
+                run.isInput[i] = true;
+                Finish(run, static_cast<uint32_t>(i));
+            }
+            Dispatch(run, cc, nodes);
+        }
+        m_pool.Wait();
+
+        std::vector<Ciphertext<DCRTPoly>> outputs;
+        for (Circuit::Wire w : circuit.GetOutputs())
+            outputs.push_back(run.values[w]);
+
+        if (stats) {
+            run.stats.ms     = TOC(t);
+            run.stats.steals = m_pool.GetSteals() - stealsBefore;
+            *stats           = run.stats;
+        }
+        return outputs;
+    }
+
+    /**
+   * Relative cost of a node: key switching dominates, then the NTT-heavy
+   * tensor products and rescales, then additions
+   */
+    static double NodeCost(CircuitOp op) {
+        switch (op) {
+            case CircuitOp::INPUT:
+                return 0;
+            case CircuitOp::MULT:
+            case CircuitOp::SQUARE:
+            case CircuitOp::ROTATE:
+            case CircuitOp::RELINEARIZE:
+                return 10;
+            case CircuitOp::MULT_NO_RELIN:
+                return 3;
+            case CircuitOp::MULT_CONST:
+            case CircuitOp::RESCALE:
+                return 2;
+            default:
+                return 1;
+        }
+    }
+
+    /**
+   * For every node, the cost of the most expensive path from it (included)
+   * to the end of the circuit
+   */
+    static std::vector<double> CriticalPath(const Circuit& circuit) {
+        const auto& nodes = circuit.GetNodes();
+        std::vector<double> path(nodes.size(), 0);
+        for (size_t i = nodes.size(); i-- > 0;) {
+            path[i] += NodeCost(nodes[i].op);
+            for (Circuit::Wire in : nodes[i].inputs)
+                path[in] = std::max(path[in], path[i]);
+        }
+        return path;
+    }
+
+private:
+    // state of one Evaluate call, guarded by mutex
+    struct Run {
+        explicit Run(size_t n)
+            : values(n), consumers(n), uses(n, 0), waitingFor(n, 0), isOutput(n, false), isInput(n, false) {}
+
+        std::mutex mutex;
+        std::vector<Ciphertext<DCRTPoly>> values;
+        std::vector<std::vector<uint32_t>> consumers;
+        std::vector<uint32_t> uses;        // consumers that have not finished
+        std::vector<uint32_t> waitingFor;  // inputs that are not done
+        std::vector<bool> isOutput;
+        std::vector<bool> isInput;
+        std::vector<double> priority;
+        std::priority_queue<std::pair<double, uint32_t>> ready;
+        uint32_t running = 0;
+        uint32_t live    = 0;
+        DagScheduleStats stats;
+    };
+
+    // with run.mutex held: node is done, queue the consumers it was the last missing input of
+    void Finish(Run& run, uint32_t node) {
+        for (uint32_t consumer : run.consumers[node])
+            if (--run.waitingFor[consumer] == 0)
+                run.ready.push({run.priority[consumer], consumer});
+    }
+
+    // with run.mutex held: start ready nodes while workers and memory allow
+    void Dispatch(Run& run, const CryptoContext<DCRTPoly>& cc, const std::vector<CircuitNode>& nodes) {
+        while (!run.ready.empty() && run.running < m_pool.GetNumThreads()) {
+            if (m_maxLive > 0 && run.running > 0 && run.live + 1 > m_maxLive) {
+                run.stats.memoryWaits++;
+                return;
+            }
+
+            uint32_t node = run.ready.top().second;
+            run.ready.pop();
+            run.running++;
+            run.live++;
+            run.stats.nodes++;
+            run.stats.maxRunning = std::max(run.stats.maxRunning, run.running);
+            run.stats.maxLive    = std::max(run.stats.maxLive, run.live);
+
+            m_pool.Submit([this, &run, &cc, &nodes, node] {
+                size_t unused = 0;
+                Ciphertext<DCRTPoly> value;
+                try {
+                    value = Circuit::EvaluateNode(cc, nodes[node], run.values, {}, unused);
+                }
+                catch (...) {
+                    // the consumers never become ready, so the run drains and Wait() rethrows
+                    std::lock_guard<std::mutex> lock(run.mutex);
+                    run.running--;
+                    throw;
+                }
+
+                std::lock_guard<std::mutex> lock(run.mutex);
+                run.values[node] = std::move(value);
+                for (Circuit::Wire in : nodes[node].inputs) {
+                    if (--run.uses[in] == 0 && !run.isOutput[in] && !run.isInput[in]) {
+                        run.values[in] = nullptr;
+                        run.live--;
+                    }
+                }
+                if (run.uses[node] == 0 && !run.isOutput[node]) {
+                    // dead value
+                    run.values[node] = nullptr;
+                    run.live--;
+                }
+                run.running--;
+                Finish(run, node);
+                Dispatch(run, cc, nodes);
+            });
+        }
+    }
+
+    WorkStealingPool& m_pool;
+    uint32_t m_maxLive;
+};
+
+}  // namespace lbcrypto
+
+#endif
@@ -0,0 +1,188 @@
+/*
+  Key switching configuration sweep: BV digit sizes against HYBRID
+
+  FastRotationsDemo2 에서 digitSize = 10 으로 고정해 두었던 것을, 여러 digitSize (와
+  HYBRID dnum) 에 대해 회로를 직접 돌려서 rotation 시간, hoisting 이득, 복호화 정밀도를
+  재고 Pareto frontier 에서 하나를 골라 CCParams 에 설정한다.
+ */
+
+#ifndef CAU_PRE_DIGIT_SIZE_TUNER_H
+#define CAU_PRE_DIGIT_SIZE_TUNER_H
+
+#include "openfhe.h"
+#include "circuit.h"
+#include "bench-fixture.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace lbcrypto {
+
+/**
+ * One key switching configuration and what it measured on the circuit
+ */
+struct KeySwitchPoint {
+    KeySwitchTechnique ksTech = BV;
+    uint32_t digitSize        = 0;  // BV only
+    uint32_t dnum             = 0;  // HYBRID only
+    uint32_t ringDim          = 0;
+    double rotationMs         = 0;  // one EvalRotate
+    double hoistedMs          = 0;  // one rotation out of a hoisted batch
+    double circuitMs          = 0;  // one run of the circuit
+    double precisionBits      = 0;  // -log2 of the largest error on the circuit outputs
+    bool pareto               = false;
+
+    // how much faster a rotation gets with hoisting
+    double HoistingGain() const {
+        return hoistedMs > 0 ? rotationMs / hoistedMs : 0;
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, const KeySwitchPoint& p) {
+        std::string name = p.ksTech == BV ? "BV digitSize=" + std::to_string(p.digitSize)
+                                          : "HYBRID dnum=" + std::to_string(p.dnum);
+        out << std::left << std::setw(18) << name << std::right << " N=" << p.ringDim << std::fixed
+            << std::setprecision(3) << " rotate=" << p.rotationMs << "ms hoisted=" << p.hoistedMs
+            << "ms gain=" << std::setprecision(2) << p.HoistingGain() << "x circuit=" << std::setprecision(3)
+            << p.circuitMs << "ms precision=" << std::setprecision(1) << p.precisionBits << " bits"
+            << (p.pareto ? " *" : "") << std::defaultfloat;
+        return out;
+    }
+};
+
+/**
+ * @brief DigitSizeTuner
+ *
+ * BV splits every RNS limb into digits of digitSize bits: smaller digits
+ * mean more digits (slower key switching, larger keys) but less key
+ * switching noise. HYBRID splits Q into dnum large digits and is usually
+ * faster for rotations that are not hoisted, while BV gains more from
+ * hoisting because its decomposition is the bigger share of the work.
+ *
+ * Sweep() builds a context for every BV digit size and every HYBRID dnum,
+ * runs the circuit on random inputs in [-1, 1] and compares it with
+ * Circuit::EvaluatePlain(). A point is on the Pareto frontier if no other
+ * point is both faster on the circuit and at least as precise. Tune()
+ * picks the fastest frontier point with at least minPrecisionBits and sets
+ * it on the CCParams.
+ */
+class DigitSizeTuner {
+public:
+    static std::vector<KeySwitchPoint> Sweep(const Circuit& circuit,
+                                             const CCParams<CryptoContextCKKSRNS>& parameters,
+                                             const std::vector<uint32_t>& digitSizes = {5, 10, 15, 20, 30},
+                                             bool withHybrid = true, uint32_t numRuns = 5) {
+        std::vector<KeySwitchPoint> points;
+        for (uint32_t digitSize : digitSizes) {
+            KeySwitchPoint p;
+            p.ksTech    = BV;
+            p.digitSize = digitSize;
+            points.push_back(p);
+        }
+        if (withHybrid) {
+            for (uint32_t dnum = 1; dnum <= parameters.GetMultiplicativeDepth() + 1; dnum++) {
+                KeySwitchPoint p;
+                p.ksTech = HYBRID;
+                p.dnum   = dnum;
+                points.push_back(p);
+            }
+        }
+
+        std::vector<KeySwitchPoint> measured;
+        for (auto& p : points) {
+            CCParams<CryptoContextCKKSRNS> candidate = parameters;
+            Apply(candidate, p);
+
+            CryptoContext<DCRTPoly> cc;
+            try {
+                cc = GenCryptoContext(candidate);
+            }
+            catch (const std::exception&) {
+                continue;
+            }
+            MeasurePoint(circuit, cc, p, parameters.GetBatchSize(), numRuns);
+            measured.push_back(p);
+        }
+
+        BenchFixture::MarkPareto(measured, [](const KeySwitchPoint& p) {
+            return std::vector<double>{p.circuitMs, -p.precisionBits};
+        });
+        return measured;
+    }
+
+    /**
+   * Sets the key switching technique and digit size / dnum of point
+   */
+    static void Apply(CCParams<CryptoContextCKKSRNS>& parameters, const KeySwitchPoint& point) {
+        parameters.SetKeySwitchTechnique(point.ksTech);
+        if (point.ksTech == BV)
+            parameters.SetDigitSize(point.digitSize);
+        else
+            parameters.SetNumLargeDigits(point.dnum);
+    }
+
+    /**
+   * Sweeps, picks the fastest Pareto point with at least minPrecisionBits
+   * (the most precise one if none reaches it) and applies it to parameters
+   */
+    static KeySwitchPoint Tune(const Circuit& circuit, CCParams<CryptoContextCKKSRNS>& parameters,
+                               double minPrecisionBits,
+                               const std::vector<uint32_t>& digitSizes = {5, 10, 15, 20, 30}) {
+        std::vector<KeySwitchPoint> points = Sweep(circuit, parameters, digitSizes);
+        if (points.empty())
+            OPENFHE_THROW(config_error, "DigitSizeTuner: no key switching configuration could be built");
+
+        const KeySwitchPoint* best = nullptr;
+        for (const auto& p : points) {
+            if (!p.pareto || p.precisionBits < minPrecisionBits)
+                continue;
+            if (!best || p.circuitMs < best->circuitMs)
+                best = &p;
+        }
+        if (!best) {
+            for (const auto& p : points)
+                if (!best || p.precisionBits > best->precisionBits)
+                    best = &p;
+        }
+
+        Apply(parameters, *best);
+        return *best;
+    }
+
+private:
+    static void MeasurePoint(const Circuit& circuit, const CryptoContext<DCRTPoly>& cc, KeySwitchPoint& p,
+                             uint32_t batchSize, uint32_t numRuns) {
+        // FastRotationsDemo 의 rotation 1..7 (hoisting 측정용) + 회로의 rotation
+        std::vector<int32_t> hoistIndices = {1, 2, 3, 4, 5, 6, 7};
+        std::vector<int32_t> rotIndices   = circuit.GetRotationIndices();
+        rotIndices.insert(rotIndices.end(), hoistIndices.begin(), hoistIndices.end());
+        std::sort(rotIndices.begin(), rotIndices.end());
+        rotIndices.erase(std::unique(rotIndices.begin(), rotIndices.end()), rotIndices.end());
+
+        BenchFixture fixture(cc, circuit.GetNumInputs(), batchSize, rotIndices);
+        p.ringDim = cc->GetRingDimension();
+
+        auto c = cc->Encrypt(fixture.GetKeys().publicKey,
+                             cc->MakeCKKSPackedPlaintext(std::vector<double>(fixture.GetBatchSize(), 0.5)));
+
+        p.rotationMs = BenchFixture::TimeMs(numRuns, [&] { cc->EvalRotate(c, 1); });
+
+        const uint32_t m = cc->GetCyclotomicOrder();
+        double batchMs   = BenchFixture::TimeMs(numRuns, [&] {
+            auto precomp = cc->EvalFastRotationPrecompute(c);
+            for (int32_t index : hoistIndices)
+                cc->EvalFastRotation(c, index, m, precomp);
+        });
+        p.hoistedMs      = batchMs / hoistIndices.size();
+
+        std::vector<Ciphertext<DCRTPoly>> outputs;
+        p.circuitMs     = BenchFixture::TimeMs(numRuns, [&] { outputs = circuit.Evaluate(cc, fixture.GetInputs()); });
+        p.precisionBits = fixture.PrecisionBits(circuit, outputs);
+    }
+};
+
+}  // namespace lbcrypto
+
+#endif
@@ -0,0 +1,188 @@
+/*
+  Automatic dnum selection for HYBRID key switching
+
+  HybridKeySwitchingDemo1/2 에서 dnum 을 손으로 바꿔 가며 비교하던 것을, 가능한 dnum 마다
+  context 를 만들어 key switching / rotation / relinearization 시간과 key 크기를 재고
+  목적 함수가 가장 작은 dnum 을 고르도록 만든 것. 결과는 파라미터 조합별로 캐시한다.
+ */
+
+#ifndef CAU_PRE_DNUM_TUNER_H
+#define CAU_PRE_DNUM_TUNER_H
+
+#include "openfhe.h"
+#include "rotation-planner.h"
+#include "bench-fixture.h"
+
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace lbcrypto {
+
+/**
+ * What "best" means: a weighted sum of the measured latencies (per ms) and
+ * of the size of one evaluation key (per MB). Candidates whose keys are
+ * larger than maxKeyBytes (if non-zero) are skipped.
+ */
+struct DnumObjective {
+    double keySwitchWeight = 0.0;
+    double rotationWeight  = 1.0;
+    double relinWeight     = 1.0;
+    double memoryWeight    = 0.0;
+    double maxKeyBytes     = 0.0;
+};
+
+/**
+ * Measurements for one dnum
+ */
+struct DnumMeasurement {
+    uint32_t dnum      = 0;
+    uint32_t ringDim   = 0;
+    double keySwitchMs = 0;
+    double rotationMs  = 0;
+    double relinMs     = 0;
+    double keyBytes    = 0;  // one evaluation key, modeled (see RotationKeyPlanner::KeyBytes)
+
+    double Score(const DnumObjective& objective) const {
+        return objective.keySwitchWeight * keySwitchMs + objective.rotationWeight * rotationMs +
+               objective.relinWeight * relinMs + objective.memoryWeight * keyBytes / (1 << 20);
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, const DnumMeasurement& m) {
+        out << "dnum=" << m.dnum << " N=" << m.ringDim << std::fixed << std::setprecision(3)
+            << " keyswitch=" << m.keySwitchMs << "ms rotate=" << m.rotationMs << "ms relin=" << m.relinMs
+            << "ms key=" << std::setprecision(1) << m.keyBytes / (1 << 20) << "MB" << std::defaultfloat;
+        return out;
+    }
+};
+
+/**
+ * @brief DnumTuner
+ *
+ * For the depth, scaling mod size, batch size and security level set in a
+ * CCParams, builds one HYBRID context per dnum = 1 .. depth+1 (skipping
+ * those OpenFHE rejects) and times KeySwitch, EvalRotate and Relinearize on
+ * each. A larger dnum makes P, and so log(QP), smaller, which may allow a
+ * smaller ring dimension, but adds digits to every key switch and to every
+ * key.
+ *
+ * The measurements do not depend on the objective and are cached per
+ * parameter set, so tuning the same parameters again (with any objective)
+ * costs nothing.
+ */
+class DnumTuner {
+public:
+    /**
+   * Measurements for every feasible dnum, from the cache if the parameter
+   * set has been measured before
+   */
+    static std::vector<DnumMeasurement> Measure(const CCParams<CryptoContextCKKSRNS>& parameters,
+                                                uint32_t numRuns = 10) {
+        CacheKey key = MakeKey(parameters);
+        {
+            std::lock_guard<std::mutex> lock(CacheMutex());
+            auto it = Cache().find(key);
+            if (it != Cache().end())
+                return it->second;
+        }
+
+        std::vector<DnumMeasurement> measurements;
+        for (uint32_t dnum = 1; dnum <= parameters.GetMultiplicativeDepth() + 1; dnum++) {
+            CCParams<CryptoContextCKKSRNS> candidate = parameters;
+            candidate.SetKeySwitchTechnique(HYBRID);
+            candidate.SetNumLargeDigits(dnum);
+
+            CryptoContext<DCRTPoly> cc;
+            try {
+                cc = GenCryptoContext(candidate);
+            }
+            catch (const std::exception&) {
+                continue;
+            }
+            measurements.push_back(MeasureContext(cc, dnum, numRuns));
+        }
+
+        std::lock_guard<std::mutex> lock(CacheMutex());
+        Cache()[key] = measurements;
+        return measurements;
+    }
+
+    /**
+   * Picks the dnum with the lowest score and sets it (and HYBRID) on
+   * parameters. Returns the chosen measurement.
+   */
+    static DnumMeasurement Tune(CCParams<CryptoContextCKKSRNS>& parameters,
+                                const DnumObjective& objective = DnumObjective(), uint32_t numRuns = 10) {
+        std::vector<DnumMeasurement> measurements = Measure(parameters, numRuns);
+
+        const DnumMeasurement* best = nullptr;
+        for (const auto& m : measurements) {
+            if (objective.maxKeyBytes > 0 && m.keyBytes > objective.maxKeyBytes)
+                continue;
+            if (!best || m.Score(objective) < best->Score(objective))
+                best = &m;
+        }
+        if (!best)
+            OPENFHE_THROW(config_error, "DnumTuner: no dnum satisfies the objective");
+
+        parameters.SetKeySwitchTechnique(HYBRID);
+        parameters.SetNumLargeDigits(best->dnum);
+        return *best;
+    }
+
+    static void ClearCache() {
+        std::lock_guard<std::mutex> lock(CacheMutex());
+        Cache().clear();
+    }
+
+private:
+    // everything in CCParams that changes the measurements, except dnum itself
+    using CacheKey = std::tuple<uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, int, int>;
+
+    static CacheKey MakeKey(const CCParams<CryptoContextCKKSRNS>& parameters) {
+        return CacheKey{parameters.GetMultiplicativeDepth(),
+                        parameters.GetScalingModSize(),
+                        parameters.GetFirstModSize(),
+                        parameters.GetBatchSize(),
+                        parameters.GetRingDim(),
+                        static_cast<int>(parameters.GetSecurityLevel()),
+                        static_cast<int>(parameters.GetScalingTechnique())};
+    }
+
+    static std::map<CacheKey, std::vector<DnumMeasurement>>& Cache() {
+        static std::map<CacheKey, std::vector<DnumMeasurement>> cache;
+        return cache;
+    }
+
+    static std::mutex& CacheMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static DnumMeasurement MeasureContext(const CryptoContext<DCRTPoly>& cc, uint32_t dnum, uint32_t numRuns) {
+        BenchFixture fixture(cc, 1, 8, {1});
+        const auto& keys = fixture.GetKeys();
+        auto keys2       = cc->KeyGen();
+        auto switchKey   = cc->KeySwitchGen(keys.secretKey, keys2.secretKey);
+
+        auto c  = fixture.GetInputs()[0];
+        auto c3 = cc->EvalMultNoRelin(c, c);
+
+        DnumMeasurement m;
+        m.dnum        = dnum;
+        m.ringDim     = cc->GetRingDimension();
+        m.keyBytes    = RotationKeyPlanner::KeyBytes(cc);
+        m.keySwitchMs = BenchFixture::TimeMs(numRuns, [&] { cc->KeySwitch(c, switchKey); });
+        m.rotationMs  = BenchFixture::TimeMs(numRuns, [&] { cc->EvalRotate(c, 1); });
+        m.relinMs     = BenchFixture::TimeMs(numRuns, [&] { cc->Relinearize(c3); });
+        return m;
+    }
+};
+
+}  // namespace lbcrypto
+
+#endif
@@ -0,0 +1,252 @@
+/*
+  Saving a CryptoContext and its keys to disk and loading them back
+
+  데모마다 GenCryptoContext, KeyGen, EvalMultKeyGen, EvalRotateKeyGen 을 처음부터 다시 하면
+  실제 크기의 파라미터에서는 프로세스를 띄울 때마다 수 초가 걸린다. 한 번 만든 context 와 key 를
+  디렉터리에 저장해 두고, 다음부터는 읽어 오기만 한다. rotation key 는 key 하나당 파일 하나로
+  저장해서 실제로 쓰는 rotation 의 key 만 읽는다.
+ */
+
+#ifndef CAU_PRE_KEY_STORE_H
+#define CAU_PRE_KEY_STORE_H
+
+#include "openfhe.h"
+#include "circuit.h"
+#include "context-registry.h"
+
+#include "cryptocontext-ser.h"
+#include "ciphertext-ser.h"
+#include "key/key-ser.h"
+#include "scheme/ckksrns/ckksrns-ser.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lbcrypto {
+
+/**
+ * Time and bytes spent by one KeyStore since it was opened
+ */
+struct KeyStoreStats {
+    double contextMs         = 0;  // context, public/secret keys, relinearization key
+    double rotationMs        = 0;
+    uint32_t rotationsLoaded = 0;
+    uint32_t rotationsStored = 0;
+    uintmax_t bytesRead      = 0;
+    uintmax_t bytesStored    = 0;  // everything in the directory
+
+    friend std::ostream& operator<<(std::ostream& out, const KeyStoreStats& s) {
+        out << std::fixed << std::setprecision(1) << "context " << s.contextMs << "ms, rotation keys "
+            << s.rotationsLoaded << "/" << s.rotationsStored << " in " << s.rotationMs << "ms, read "
+            << s.bytesRead / double(1 << 20) << "MB of " << s.bytesStored / double(1 << 20) << "MB"
+            << std::defaultfloat;
+        return out;
+    }
+};
+
+/**
+ * @brief KeyStore
+ *
+ * A directory holding everything needed to evaluate without generating keys:
+ *
+ *   parameters.txt, the CCParams the context was generated from
+ *   cryptocontext.bin, key-public.bin, key-secret.bin, key-eval-mult.bin
+ *   rotation-<automorphism index>.bin, one per rotation key
+ *
+ * Save() writes it once. Exists(parameters) tells whether the directory
+ * holds a store for exactly those parameters (compared in the canonical
+ * form of ContextRegistry::CanonicalKey), so a store left behind by other
+ * parameters is regenerated instead of silently reused. Load() reads the context, the key pair and the
+ * relinearization key, and no rotation key; LoadRotations() then reads the
+ * keys of the given rotations that are not loaded yet and adds them to the
+ * context's automorphism key map. A process that only rotates by 1 and 2
+ * therefore reads two keys, however many were saved.
+ *
+ * OpenFHE keeps contexts and evaluation keys in process-wide maps, and
+ * deserializing a context whose parameters match one that is already alive
+ * returns the live one. Load() is meant for a fresh process; to reload in
+ * the same process, clear the evaluation keys of the saved key tag first
+ * (see KeyStoreDemo). The live context is then reused, which leaves other
+ * contexts of the process alone.
+ *
+ * The secret key is written in the clear, like the rest; the store is for
+ * experiments and benchmarks on one machine, not for deployment.
+ */
+class KeyStore {
+public:
+    explicit KeyStore(std::string directory) : m_directory(std::move(directory)) {}
+
+    // true if Save() has been run on the directory
+    bool Exists() const {
+        return std::filesystem::exists(Path("cryptocontext.bin"));
+    }
+
+    // true if Save() has been run on the directory with these parameters
+    bool Exists(const CCParams<CryptoContextCKKSRNS>& parameters) const {
+        if (!Exists())
+            return false;
+        std::ifstream in(Path("parameters.txt"));
+        std::string saved((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        return in && saved == ContextRegistry::CanonicalKey(parameters);
+    }
+
+    /**
+   * Writes cc, generated from parameters, and its keys, replacing what the
+   * directory held before (rotation keys of an older store included)
+   */
+    void Save(const CCParams<CryptoContextCKKSRNS>& parameters, const CryptoContext<DCRTPoly>& cc,
+              const KeyPair<DCRTPoly>& keys) {
+        // parameters.txt goes last, so a store that failed half-way never matches
+        std::filesystem::create_directories(m_directory);
+        std::filesystem::remove(Path("parameters.txt"));
+        for (const auto& entry : std::filesystem::directory_iterator(m_directory))
+            if (entry.path().filename().string().rfind("rotation-", 0) == 0)
+                std::filesystem::remove(entry.path());
+
+        if (!Serial::SerializeToFile(Path("cryptocontext.bin"), cc, SerType::BINARY) ||
+            !Serial::SerializeToFile(Path("key-public.bin"), keys.publicKey, SerType::BINARY) ||
+            !Serial::SerializeToFile(Path("key-secret.bin"), keys.secretKey, SerType::BINARY))
+            OPENFHE_THROW(openfhe_error, "KeyStore: cannot write to " + m_directory);
+
+        std::ofstream mult(Path("key-eval-mult.bin"), std::ios::binary);
+        if (!mult || !cc->SerializeEvalMultKey(mult, SerType::BINARY, keys.secretKey->GetKeyTag()))
+            OPENFHE_THROW(openfhe_error, "KeyStore: cannot write the relinearization key");
+
+        // rotation keys one by one, named after the automorphism they implement
+        const std::string tag = keys.secretKey->GetKeyTag();
+        auto& allRotationKeys = cc->GetAllEvalAutomorphismKeys();
+        if (allRotationKeys.find(tag) != allRotationKeys.end()) {
+            for (const auto& [index, key] : *allRotationKeys[tag]) {
+                std::ofstream out(RotationPath(index), std::ios::binary);
+                Serial::Serialize(key, out, SerType::BINARY);
+                if (!out)
+                    OPENFHE_THROW(openfhe_error, "KeyStore: cannot write rotation key " + std::to_string(index));
+            }
+        }
+
+        std::ofstream params(Path("parameters.txt"));
+        params << ContextRegistry::CanonicalKey(parameters);
+        if (!params.flush())
+            OPENFHE_THROW(openfhe_error, "KeyStore: cannot write the parameters");
+
+        m_cc   = cc;
+        m_keys = keys;
+    }
+
+    /**
+   * Reads the context, the key pair and the relinearization key; rotation
+   * keys are read by LoadRotations()
+   */
+    CryptoContext<DCRTPoly> Load() {
+        if (!Exists())
+            OPENFHE_THROW(config_error, "KeyStore: nothing saved in " + m_directory);
+
+        TimeVar t;
+        TIC(t);
+        CryptoContext<DCRTPoly> cc;
+        KeyPair<DCRTPoly> keys;
+        if (!Serial::DeserializeFromFile(Path("cryptocontext.bin"), cc, SerType::BINARY) ||
+            !Serial::DeserializeFromFile(Path("key-public.bin"), keys.publicKey, SerType::BINARY) ||
+            !Serial::DeserializeFromFile(Path("key-secret.bin"), keys.secretKey, SerType::BINARY))
+            OPENFHE_THROW(deserialize_error, "KeyStore: cannot read from " + m_directory);
+
+        std::ifstream mult(Path("key-eval-mult.bin"), std::ios::binary);
+        if (!mult || !cc->DeserializeEvalMultKey(mult, SerType::BINARY))
+            OPENFHE_THROW(deserialize_error, "KeyStore: cannot read the relinearization key");
+        m_stats.contextMs = TOC(t);
+        m_stats.bytesRead += FileSize("cryptocontext.bin") + FileSize("key-public.bin") +
+                             FileSize("key-secret.bin") + FileSize("key-eval-mult.bin");
+
+        m_cc   = cc;
+        m_keys = keys;
+        return cc;
+    }
+
+    /**
+   * Makes the keys for the given rotations available to EvalRotate, reading
+   * the ones not loaded yet. Throws if one of them was never saved or cannot
+   * be read.
+   */
+    void LoadRotations(const std::vector<int32_t>& indices) {
+        if (!m_cc)
+            OPENFHE_THROW(config_error, "KeyStore: call Load() or Save() first");
+
+        TimeVar t;
+        TIC(t);
+        const std::string tag = m_keys.secretKey->GetKeyTag();
+        auto& allRotationKeys = m_cc->GetAllEvalAutomorphismKeys();
+        auto& rotationKeys    = allRotationKeys[tag];
+        if (!rotationKeys)
+            rotationKeys = std::make_shared<std::map<usint, EvalKey<DCRTPoly>>>();
+
+        for (int32_t index : indices) {
+            usint automorphism = FindAutomorphismIndex2nComplex(index, m_cc->GetCyclotomicOrder());
+            if (rotationKeys->find(automorphism) != rotationKeys->end())
+                continue;
+
+            std::ifstream in(RotationPath(automorphism), std::ios::binary);
+            if (!in)
+                OPENFHE_THROW(config_error, "KeyStore: no key saved for rotation " + std::to_string(index));
+            EvalKey<DCRTPoly> key;
+            Serial::Deserialize(key, in, SerType::BINARY);
+            if (!in || !key)
+                OPENFHE_THROW(deserialize_error, "KeyStore: cannot read rotation key " + std::to_string(index));
+            (*rotationKeys)[automorphism] = key;
+            m_stats.rotationsLoaded++;
+            m_stats.bytesRead += std::filesystem::file_size(RotationPath(automorphism));
+        }
+        m_stats.rotationMs += TOC(t);
+    }
+
+    // the rotation keys a circuit's ROTATE nodes use
+    void LoadRotations(const Circuit& circuit) {
+        LoadRotations(circuit.GetRotationIndices());
+    }
+
+    const KeyPair<DCRTPoly>& GetKeys() const {
+        return m_keys;
+    }
+
+    KeyStoreStats GetStats() const {
+        KeyStoreStats stats   = m_stats;
+        stats.rotationsStored = 0;
+        stats.bytesStored     = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(m_directory)) {
+            if (entry.path().filename().string().rfind("rotation-", 0) == 0)
+                stats.rotationsStored++;
+            stats.bytesStored += entry.file_size();
+        }
+        return stats;
+    }
+
+private:
+    std::string Path(const std::string& name) const {
+        return (std::filesystem::path(m_directory) / name).string();
+    }
+
+    std::string RotationPath(usint automorphism) const {
+        return Path("rotation-" + std::to_string(automorphism) + ".bin");
+    }
+
+    uintmax_t FileSize(const std::string& name) const {
+        return std::filesystem::file_size(Path(name));
+    }
+
+    std::string m_directory;
+    CryptoContext<DCRTPoly> m_cc;
+    KeyPair<DCRTPoly> m_keys;
+    KeyStoreStats m_stats;
+};
+
+}  // namespace lbcrypto
+
+#endif
@@ -0,0 +1,85 @@
+/*
+  Fused multiply-accumulate for CKKS ciphertexts
+
+  a1*b1 + a2*b2 + ... 를 EvalMult + EvalAdd 로 계산하면 항마다 relinearize 와 결과 암호문
+  할당이 생긴다. 곱셈 결과를 원소 3개짜리 accumulator 에 바로 더해 두고 마지막에 한 번만
+  relinearize 한다.
+ */
+
+#ifndef CAU_PRE_MULT_ACCUMULATE_H
+#define CAU_PRE_MULT_ACCUMULATE_H
+
+#include "openfhe.h"
+
+#include <vector>
+
+namespace lbcrypto {
+
+/**
+ * acc += a * b without relinearization; acc keeps three elements.
+ *
+ * If acc is empty it becomes EvalMultNoRelin(a, b). Otherwise, when a and b
+ * are two-element ciphertexts at the same level and scaling degree as the
+ * terms already in acc, the tensor product is added into the elements of acc
+ * directly (3 polynomial products, Karatsuba style, and no new ciphertext).
+ * Any other combination falls back to EvalMultNoRelin + EvalAddInPlace,
+ * which adjusts levels and scales as usual.
+ *
+ * acc is modified in place, so it must not be shared with other owners.
+ */
+inline void EvalMultAccumulate(const CryptoContext<DCRTPoly>& cc, Ciphertext<DCRTPoly>& acc,
+                               ConstCiphertext<DCRTPoly> a, ConstCiphertext<DCRTPoly> b) {
+    if (!acc) {
+        acc = cc->EvalMultNoRelin(a, b);
+        return;
+    }
+
+    const auto& ea = a->GetElements();
+    const auto& eb = b->GetElements();
+    auto& e        = acc->GetElements();
+
+    bool fused = ea.size() == 2 && eb.size() == 2 && e.size() == 3 && a->GetLevel() == b->GetLevel() &&
+                 acc->GetLevel() == a->GetLevel() &&
+                 acc->GetNoiseScaleDeg() == a->GetNoiseScaleDeg() + b->GetNoiseScaleDeg() &&
+                 acc->GetScalingFactor() == a->GetScalingFactor() * b->GetScalingFactor() &&
+                 e[0].GetNumOfElements() == ea[0].GetNumOfElements() &&
+                 e[0].GetNumOfElements() == eb[0].GetNumOfElements();
+
+    if (!fused) {
+        cc->EvalAddInPlace(acc, cc->EvalMultNoRelin(a, b));
+        return;
+    }
+
+    // (a0 + a1 s)(b0 + b1 s) = a0 b0 + ((a0 + a1)(b0 + b1) - a0 b0 - a1 b1) s + a1 b1 s^2
+    DCRTPoly p0    = ea[0] * eb[0];
+    DCRTPoly p2    = ea[1] * eb[1];
+    DCRTPoly cross = (ea[0] + ea[1]) * (eb[0] + eb[1]);
+    cross -= p0;
+    cross -= p2;
+
+    e[0] += p0;
+    e[1] += cross;
+    e[2] += p2;
+}
+
+/**
+ * a[0]*b[0] + a[1]*b[1] + ... with a single relinearization (one key switch
+ * instead of one per term)
+ */
+inline Ciphertext<DCRTPoly> EvalInnerProduct(const CryptoContext<DCRTPoly>& cc,
+                                             const std::vector<Ciphertext<DCRTPoly>>& a,
+                                             const std::vector<Ciphertext<DCRTPoly>>& b) {
+    if (a.empty() || a.size() != b.size())
+        OPENFHE_THROW(config_error, "EvalInnerProduct: expected two non-empty vectors of the same length");
+
+    Ciphertext<DCRTPoly> acc;
+    for (size_t i = 0; i < a.size(); i++)
+        EvalMultAccumulate(cc, acc, a[i], b[i]);
+
+    cc->RelinearizeInPlace(acc);
+    return acc;
+}
+
+}  // namespace lbcrypto
+
+#endif
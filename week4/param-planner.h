@@ -0,0 +1,372 @@
+/*
+  Circuit-driven CKKS parameter selection
+
+  SetMultiplicativeDepth / SetScalingModSize / SetBatchSize 등을 직접 정하는 대신,
+  기록된 Circuit 과 목표 정밀도, 보안 수준으로부터 파라미터를 골라주는 planner.
+ */
+
+#ifndef CAU_PRE_PARAM_PLANNER_H
+#define CAU_PRE_PARAM_PLANNER_H
+
+#include "openfhe.h"
+#include "circuit.h"
+#include "bench-fixture.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace lbcrypto {
+
+/**
+ * What the circuit needs from its parameters
+ */
+struct PlannerTarget {
+    // bits of precision wanted after decryption (after the decimal point)
+    uint32_t precisionBits = 20;
+    // bits needed for the integer part of the largest intermediate value
+    uint32_t integerBits = 10;
+    SecurityLevel securityLevel = HEStd_128_classic;
+    ScalingTechnique scalTech   = FLEXIBLEAUTO;
+};
+
+/**
+ * One candidate parameter set, with its modeled (and optionally measured) cost
+ */
+struct ParameterPlan {
+    uint32_t multDepth          = 0;
+    uint32_t scalingModSize     = 0;
+    uint32_t firstModSize       = 0;
+    uint32_t ringDim            = 0;
+    uint32_t batchSize          = 0;
+    ScalingTechnique scalTech   = FLEXIBLEAUTO;
+    SecurityLevel securityLevel = HEStd_128_classic;
+    KeySwitchTechnique ksTech   = HYBRID;
+    uint32_t dnum               = 0;  // HYBRID only
+    uint32_t numP               = 0;  // number of special primes, HYBRID only
+    uint32_t digitSize          = 0;  // BV only, 0 for one digit per RNS limb
+    uint32_t logQP              = 0;  // bits of the largest modulus used in key switching
+    double modeledCost          = 0;  // coefficient operations, see ParameterPlanner::ModelCost
+    double measuredMs           = -1;  // -1 if not measured
+
+    /**
+   * The ring dimension is left to OpenFHE, which derives it from the moduli
+   * it actually generates and the security level; ringDim and logQP here
+   * are the planner's model until ParameterPlanner::Build() replaces them
+   * with the real values.
+   */
+    CCParams<CryptoContextCKKSRNS> ToCCParams() const {
+        CCParams<CryptoContextCKKSRNS> parameters;
+        parameters.SetMultiplicativeDepth(multDepth);
+        parameters.SetScalingModSize(scalingModSize);
+        parameters.SetFirstModSize(firstModSize);
+        parameters.SetScalingTechnique(scalTech);
+        parameters.SetBatchSize(batchSize);
+        parameters.SetSecurityLevel(securityLevel);
+        parameters.SetKeySwitchTechnique(ksTech);
+        if (ksTech == HYBRID)
+            parameters.SetNumLargeDigits(dnum);
+        else
+            parameters.SetDigitSize(digitSize);
+        return parameters;
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, const ParameterPlan& plan) {
+        out << "depth=" << plan.multDepth << " scalingModSize=" << plan.scalingModSize
+            << " firstModSize=" << plan.firstModSize << " N=" << plan.ringDim << " logQP=" << plan.logQP << " "
+            << (plan.ksTech == HYBRID ? "HYBRID dnum=" + std::to_string(plan.dnum)
+                                      : "BV digitSize=" + std::to_string(plan.digitSize))
+            << " modeled=" << std::fixed << std::setprecision(1) << plan.modeledCost / 1e6 << "M";
+        if (plan.measuredMs >= 0)
+            out << " measured=" << std::setprecision(2) << plan.measuredMs << "ms";
+        out << std::defaultfloat;
+        return out;
+    }
+};
+
+/**
+ * @brief ParameterPlanner
+ *
+ * Derives CKKS parameters from a recorded Circuit:
+ *
+ * - the multiplicative depth is the depth of the circuit;
+ * - scalingModSize = precisionBits + SCALING_NOISE_BITS, and firstModSize
+ *   leaves integerBits on top of it;
+ * - for every key switching choice (HYBRID with dnum = 1..depth+1, and BV),
+ *   the ring dimension is the smallest one allowed by the HE standard for
+ *   the modeled log(QP) at the requested security level;
+ * - BV gets the largest digit size whose key switching noise, about
+ *   2^digitSize sqrt(N digits), still leaves precisionBits below the scale
+ *   (no candidate if none does);
+ * - the candidates are ranked with a cost model counting NTTs and
+ *   coefficient-wise products for every operation of the circuit at the
+ *   level it runs at.
+ *
+ * Plan() can additionally build the best few candidates and time the circuit
+ * on each of them, in which case the measured time decides.
+ *
+ * The modeled N only ranks the candidates. Build() lets OpenFHE choose N for
+ * the moduli it really generates, so a model that underestimates log(QP)
+ * gives a larger N rather than a context that fails the security check,
+ * and writes the actual N and log(QP) back into the plan.
+ */
+class ParameterPlanner {
+public:
+    // bits lost to encoding/encryption/rescaling noise, empirically 10-15 for
+    // the small depths used here
+    static constexpr uint32_t SCALING_NOISE_BITS = 12;
+    // native word limit for CRT moduli
+    static constexpr uint32_t MAX_MOD_SIZE = 60;
+    // bit size of the special primes (P) in HYBRID key switching
+    static constexpr uint32_t AUX_MOD_SIZE = 60;
+
+    /**
+   * All feasible candidates, cheapest modeled cost first
+   */
+    static std::vector<ParameterPlan> Candidates(const Circuit& circuit, const PlannerTarget& target) {
+        ParameterPlan base;
+        base.multDepth      = std::max<uint32_t>(circuit.GetDepth(), 1);
+        base.scalingModSize = target.precisionBits + SCALING_NOISE_BITS;
+        base.firstModSize   = std::min(MAX_MOD_SIZE, base.scalingModSize + target.integerBits);
+        base.scalTech       = target.scalTech;
+        base.securityLevel  = target.securityLevel;
+        base.batchSize      = RequiredSlots(circuit);
+
+        if (base.scalingModSize >= MAX_MOD_SIZE || base.firstModSize <= base.scalingModSize)
+            OPENFHE_THROW(config_error, "ParameterPlanner: " + std::to_string(target.precisionBits) +
+                                            " bits of precision with " + std::to_string(target.integerBits) +
+                                            " integer bits do not fit in a " + std::to_string(MAX_MOD_SIZE) +
+                                            "-bit modulus");
+
+        uint32_t numQ = base.multDepth + 1;
+        uint32_t logQ = base.firstModSize + base.multDepth * base.scalingModSize;
+
+        std::vector<ParameterPlan> candidates;
+        for (uint32_t dnum = 1; dnum <= numQ; dnum++) {
+            ParameterPlan plan = base;
+            plan.ksTech        = HYBRID;
+            plan.dnum          = dnum;
+            // P must be larger than the largest digit
+            uint32_t digitLimbs = (numQ + dnum - 1) / dnum;
+            uint32_t digitBits  = base.firstModSize + (digitLimbs - 1) * base.scalingModSize;
+            plan.numP           = (digitBits + AUX_MOD_SIZE - 1) / AUX_MOD_SIZE;
+            plan.logQP          = logQ + plan.numP * AUX_MOD_SIZE;
+            if (Finish(circuit, plan))
+                candidates.push_back(plan);
+        }
+
+        ParameterPlan bv = base;
+        bv.ksTech        = BV;
+        bv.logQP         = logQ;
+        if (Finish(circuit, bv) && ChooseDigitSize(bv, target.precisionBits)) {
+            bv.modeledCost = ModelCost(circuit, bv);
+            candidates.push_back(bv);
+        }
+
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const ParameterPlan& a, const ParameterPlan& b) { return a.modeledCost < b.modeledCost; });
+        return candidates;
+    }
+
+    /**
+   * Picks the cheapest candidate. With numMeasured > 0, the numMeasured
+   * cheapest modeled candidates are built and timed on the circuit, and the
+   * fastest one is returned.
+   */
+    static ParameterPlan Plan(const Circuit& circuit, const PlannerTarget& target, uint32_t numMeasured = 0) {
+        std::vector<ParameterPlan> candidates = Candidates(circuit, target);
+        if (candidates.empty())
+            OPENFHE_THROW(config_error, "ParameterPlanner: no ring dimension satisfies the security level");
+
+        if (numMeasured == 0)
+            return candidates[0];
+
+        size_t best = 0;
+        for (size_t i = 0; i < std::min<size_t>(numMeasured, candidates.size()); i++) {
+            candidates[i].measuredMs = Measure(circuit, candidates[i]);
+            if (candidates[i].measuredMs < candidates[best].measuredMs)
+                best = i;
+        }
+        return candidates[best];
+    }
+
+    /**
+   * Largest log2(QP) allowed for ring dimension n by the HE standard
+   * (ternary secrets, classical attacks). 0 if n is too small for any
+   * modulus at that level.
+   */
+    static uint32_t MaxLogQP(uint32_t n, SecurityLevel level) {
+        // n = 2^10 ... 2^17
+        static const uint32_t table128[] = {27, 54, 109, 218, 438, 881, 1761, 3524};
+        static const uint32_t table192[] = {19, 37, 75, 152, 305, 611, 1228, 2468};
+        static const uint32_t table256[] = {14, 29, 58, 118, 237, 476, 956, 1926};
+
+        uint32_t logn = 0;
+        while ((1u << logn) < n)
+            logn++;
+        if (logn < 10 || logn > 17)
+            return 0;
+
+        switch (level) {
+            case HEStd_128_classic:
+                return table128[logn - 10];
+            case HEStd_192_classic:
+                return table192[logn - 10];
+            case HEStd_256_classic:
+                return table256[logn - 10];
+            default:
+                return UINT32_MAX;
+        }
+    }
+
+    /**
+   * Modeled cost of running the circuit with the given plan. Units are
+   * coefficient operations: an NTT over one RNS limb costs N log2 N, a
+   * coefficient-wise product over one limb costs N.
+   */
+    static double ModelCost(const Circuit& circuit, const ParameterPlan& plan) {
+        const double n      = plan.ringDim;
+        const double ntt    = n * std::log2(n);
+        const uint32_t numQ = plan.multDepth + 1;
+
+        std::vector<uint32_t> levels = circuit.GetLevels();
+        const auto& nodes            = circuit.GetNodes();
+
+        double cost = 0;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            // operations run on the limbs left at the level of their inputs
+            uint32_t level = levels[i] - (Circuit::ConsumesLevel(nodes[i].op) ? 1 : 0);
+            double limbs   = numQ - std::min(level, numQ - 1);
+
+            switch (nodes[i].op) {
+                case CircuitOp::ADD:
+                case CircuitOp::SUB:
+                case CircuitOp::ADD_CONST:
+                    cost += 2 * limbs * n;
+                    break;
+                case CircuitOp::MULT_CONST:
+                    cost += 2 * limbs * n + 2 * limbs * ntt;  // product + rescale
+                    break;
+                case CircuitOp::MULT:
+                case CircuitOp::SQUARE:
+                    cost += 4 * limbs * n + KeySwitchCost(plan, limbs, n, ntt) + 2 * limbs * ntt;
+                    break;
+                case CircuitOp::MULT_NO_RELIN:
+                    cost += 4 * limbs * n + 2 * limbs * ntt;
+                    break;
+                case CircuitOp::RELINEARIZE:
+                    cost += KeySwitchCost(plan, limbs, n, ntt);
+                    break;
+                case CircuitOp::ROTATE:
+                    cost += 2 * limbs * n + KeySwitchCost(plan, limbs, n, ntt);
+                    break;
+                case CircuitOp::RESCALE:
+                    cost += 2 * limbs * ntt;
+                    break;
+                default:
+                    break;
+            }
+        }
+        return cost;
+    }
+
+    /**
+   * Generates the context of plan and replaces the modeled ring dimension,
+   * number of special primes and log(QP) in plan with those of the context
+   */
+    static CryptoContext<DCRTPoly> Build(const Circuit& circuit, ParameterPlan& plan) {
+        CryptoContext<DCRTPoly> cc = GenCryptoContext(plan.ToCCParams());
+
+        uint32_t logQP = 0;
+        for (const auto& q : cc->GetElementParams()->GetParams())
+            logQP += q->GetModulus().GetMSB();
+        if (plan.ksTech == HYBRID) {
+            const auto cryptoParams = std::dynamic_pointer_cast<CryptoParametersRNS>(cc->GetCryptoParameters());
+            const auto paramsP      = cryptoParams->GetParamsP()->GetParams();
+            plan.numP               = paramsP.size();
+            for (const auto& p : paramsP)
+                logQP += p->GetModulus().GetMSB();
+        }
+        plan.logQP       = logQP;
+        plan.ringDim     = cc->GetRingDimension();
+        plan.modeledCost = ModelCost(circuit, plan);
+        return cc;
+    }
+
+    /**
+   * Time (ms) of one run of the circuit with the given parameters, inputs
+   * drawn uniformly from [-1, 1]. plan gets the actual N and log(QP), see
+   * Build().
+   */
+    static double Measure(const Circuit& circuit, ParameterPlan& plan) {
+        CryptoContext<DCRTPoly> cc = Build(circuit, plan);
+        BenchFixture fixture(cc, circuit.GetNumInputs(), plan.batchSize, circuit.GetRotationIndices());
+        return BenchFixture::TimeMs(1, [&] { circuit.Evaluate(cc, fixture.GetInputs()); });
+    }
+
+private:
+    // batch size: the slots of the circuit, enough for every rotation, a power of two
+    static uint32_t RequiredSlots(const Circuit& circuit) {
+        uint32_t slots = std::max<uint32_t>(circuit.GetSlots(), 1);
+        for (int32_t index : circuit.GetRotationIndices())
+            slots = std::max<uint32_t>(slots, std::abs(index) + 1);
+        uint32_t batch = 1;
+        while (batch < slots)
+            batch *= 2;
+        return batch;
+    }
+
+    // picks the ring dimension and the modeled cost; false if infeasible
+    static bool Finish(const Circuit& circuit, ParameterPlan& plan) {
+        uint32_t n = std::max<uint32_t>(1024, 2 * plan.batchSize);
+        while (plan.logQP > MaxLogQP(n, plan.securityLevel)) {
+            n *= 2;
+            if (n > (1u << 17))
+                return false;
+        }
+        plan.ringDim     = n;
+        plan.modeledCost = ModelCost(circuit, plan);
+        return true;
+    }
+
+    // BV digits of one RNS limb of the given size
+    static double DigitsPerLimb(uint32_t digitSize, uint32_t modSize) {
+        return digitSize == 0 ? 1 : std::ceil(static_cast<double>(modSize) / digitSize);
+    }
+
+    // largest BV digit size whose key switching noise leaves precisionBits; false if none
+    static bool ChooseDigitSize(ParameterPlan& plan, uint32_t precisionBits) {
+        for (uint32_t digitSize : {0u, 30u, 20u, 15u, 10u, 5u, 3u}) {
+            double digits = DigitsPerLimb(digitSize, plan.firstModSize) +
+                            plan.multDepth * DigitsPerLimb(digitSize, plan.scalingModSize);
+            double digitBits = digitSize == 0 ? plan.firstModSize : std::min(digitSize, plan.firstModSize);
+            double noiseBits = digitBits + 0.5 * std::log2(plan.ringDim * digits);
+            if (noiseBits + precisionBits <= plan.scalingModSize) {
+                plan.digitSize = digitSize;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static double KeySwitchCost(const ParameterPlan& plan, double limbs, double n, double ntt) {
+        if (plan.ksTech == BV) {
+            // every limb split into digits, each NTT'ed to every limb, two key products
+            double digits = limbs * DigitsPerLimb(plan.digitSize, plan.scalingModSize);
+            return digits * limbs * ntt + 2 * digits * limbs * n + 2 * limbs * ntt;
+        }
+        // HYBRID: ModUp of the digits to Q*P, key products, ModDown of two polynomials
+        const uint32_t numQ = plan.multDepth + 1;
+        double alpha        = std::ceil(static_cast<double>(numQ) / plan.dnum);
+        double digits       = std::ceil(limbs / alpha);
+        double extended     = limbs + plan.numP;
+        return digits * extended * ntt + 2 * digits * extended * n + 2 * extended * ntt;
+    }
+};
+
+}  // namespace lbcrypto
+
+#endif
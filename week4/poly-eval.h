@@ -0,0 +1,111 @@
+/*
+  Polynomial evaluation engine for CKKS (baby-step giant-step / Paterson-Stockmeyer)
+
+  week3, week4 에서 (x+1)^2(x^2+2) 를 EvalAdd/EvalMult 로 직접 풀어 쓰던 부분을
+  계수 (또는 인수들의 곱) 만 넘기면 계산하도록 바꾼 것. schedule 은 poly-schedule.h 에 있고,
+  여기에는 OpenFHE 쪽 backend 만 있다. SEAL 쪽은 week3/ckks_poly_evaluator.h.
+ */
+
+#ifndef CAU_PRE_POLY_EVAL_H
+#define CAU_PRE_POLY_EVAL_H
+
+#include "openfhe.h"
+#include "poly-schedule.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace lbcrypto {
+
+/**
+ * @brief PolyEvaluator
+ *
+ * Evaluates p(x) = c[0] + c[1] x + ... + c[d] x^d on a CKKS ciphertext with
+ * the PolySchedule baby-step giant-step schedule; see PolySchedule for the
+ * number of multiplications and the depth.
+ *
+ * With FIXEDMANUAL the evaluator rescales after every multiplication itself;
+ * with FLEXIBLEAUTO/FIXEDAUTO OpenFHE does it.
+ */
+class PolyEvaluator {
+public:
+    using Plan = PolySchedule::Plan;
+
+    static std::vector<double> ExpandFactors(const std::vector<std::vector<double>>& factors) {
+        return PolySchedule::ExpandFactors(factors);
+    }
+
+    static Plan MakePlan(const std::vector<double>& coefficients, uint32_t extraDepth = 0) {
+        return PolySchedule::MakePlan(coefficients, extraDepth);
+    }
+
+    /**
+   * Evaluates the polynomial with coefficients c[0], ..., c[d] at ct.
+   */
+    static Ciphertext<DCRTPoly> EvalPolynomial(const CryptoContext<DCRTPoly>& cc, ConstCiphertext<DCRTPoly> ct,
+                                               const std::vector<double>& coefficients, uint32_t extraDepth = 0) {
+        CryptoBackend backend(cc, ct);
+        return EvalWithBackend(backend, coefficients, extraDepth);
+    }
+
+    /**
+   * Runs the planned schedule on any backend that provides Input(), Mult(),
+   * MultConst(), Add() and AddConst() on its Value type (see CryptoBackend
+   * below); used for instance to record the schedule into a Circuit.
+   */
+    template <class Backend>
+    static typename Backend::Value EvalWithBackend(Backend& backend, const std::vector<double>& coefficients,
+                                                   uint32_t extraDepth = 0) {
+        if (PolySchedule::Degree(coefficients) < 1)
+            OPENFHE_THROW(math_error, "PolyEvaluator: polynomial must have degree at least 1");
+        return PolySchedule::Evaluate(backend, coefficients, extraDepth);
+    }
+
+    /**
+   * Evaluates a polynomial given as a product of factors (see ExpandFactors).
+   */
+    static Ciphertext<DCRTPoly> EvalFactors(const CryptoContext<DCRTPoly>& cc, ConstCiphertext<DCRTPoly> ct,
+                                            const std::vector<std::vector<double>>& factors,
+                                            uint32_t extraDepth = 0) {
+        return EvalPolynomial(cc, ct, ExpandFactors(factors), extraDepth);
+    }
+
+private:
+    struct CryptoBackend {
+        using Value = Ciphertext<DCRTPoly>;
+
+        CryptoBackend(const CryptoContext<DCRTPoly>& cc, ConstCiphertext<DCRTPoly> ct) : cc(cc), ct(ct) {
+            const auto cryptoParams = std::dynamic_pointer_cast<CryptoParametersRNS>(cc->GetCryptoParameters());
+            manualRescale           = cryptoParams && cryptoParams->GetScalingTechnique() == FIXEDMANUAL;
+        }
+
+        Value Input() {
+            return ct->Clone();
+        }
+        Value Mult(const Value& a, const Value& b) {
+            return Rescaled(cc->EvalMult(a, b));
+        }
+        Value MultConst(const Value& a, double c) {
+            return Rescaled(cc->EvalMult(a, c));
+        }
+        Value Add(const Value& a, const Value& b) {
+            return cc->EvalAdd(a, b);
+        }
+        Value AddConst(const Value& a, double c) {
+            return cc->EvalAdd(a, c);
+        }
+
+    private:
+        Value Rescaled(Value v) {
+            return manualRescale ? cc->Rescale(v) : v;
+        }
+
+        CryptoContext<DCRTPoly> cc;
+        ConstCiphertext<DCRTPoly> ct;
+        bool manualRescale = false;
+    };
+};
+
+}  // namespace lbcrypto
+
+#endif
@@ -0,0 +1,291 @@
+/*
+  Baby-step giant-step (Paterson-Stockmeyer) schedule for polynomial evaluation
+
+  poly-eval.h (OpenFHE) 가 쓰는 부분. SEAL 쪽 (week3) 은 ckks_poly_schedule.h 에 따로 있다.
+  어떤 라이브러리에도 의존하지 않고, 곱셈/덧셈을 backend 에 맡긴다.
+ */
+
+#ifndef CAU_PRE_POLY_SCHEDULE_H
+#define CAU_PRE_POLY_SCHEDULE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace lbcrypto {
+
+/**
+ * @brief PolySchedule
+ *
+ * Evaluates p(x) = c[0] + c[1] x + ... + c[d] x^d on any backend with a
+ * baby-step giant-step (Paterson-Stockmeyer) schedule:
+ *
+ * - baby steps x, x^2, ..., x^(k-1) (k a power of two), each x^i computed at
+ *   depth ceil(log2 i);
+ * - giant steps x^k, x^(2k), x^(4k), ... by repeated squaring;
+ * - p is split recursively as p = q * x^(k 2^j) + r until every piece has
+ *   degree < k, and the pieces are linear combinations of the baby steps.
+ *
+ * The number of non-scalar multiplications is about k + d/k + log2(d/k) instead
+ * of d. A coefficient other than 0 and 1 costs a scalar multiplication, and
+ * so one level, on the power it multiplies. For general coefficients the
+ * depth is ceil(log2(d+1)): ceil(log2 d) for x^d, plus one when d is a power
+ * of two and x^d itself is multiplied by a coefficient. Coefficients equal to
+ * 1 on the deepest powers save that level, e.g. (x+1)^2 (x^2+2) =
+ * x^4 + 2x^3 + 3x^2 + 4x + 2 has depth 2. MakePlan() reports the exact depth;
+ * it chooses k to minimize the depth first and the number of non-scalar
+ * multiplications second.
+ *
+ * A backend provides Input(), Mult(), MultConst(), Add() and AddConst() on
+ * its Value type; additions are assumed to cost no depth.
+ */
+class PolySchedule {
+public:
+    /**
+   * Cost of a schedule, computed without touching any ciphertext
+   */
+    struct Plan {
+        uint32_t babySteps      = 1;  // k
+        uint32_t depth          = 0;  // multiplicative depth of the whole evaluation
+        uint32_t nonScalarMults = 0;  // ciphertext x ciphertext multiplications
+        uint32_t scalarMults    = 0;  // ciphertext x constant multiplications
+    };
+
+    /**
+   * Multiplies out a product of factors, e.g. (x+1)^2 (x^2+2) is
+   * {{1, 1}, {1, 1}, {2, 0, 1}}. Each factor lists its coefficients from
+   * degree 0 upwards.
+   */
+    static std::vector<double> ExpandFactors(const std::vector<std::vector<double>>& factors) {
+        std::vector<double> result = {1.0};
+        for (const auto& factor : factors) {
+            if (factor.empty())
+                continue;
+            std::vector<double> next(result.size() + factor.size() - 1, 0.0);
+            for (size_t i = 0; i < result.size(); i++)
+                for (size_t j = 0; j < factor.size(); j++)
+                    next[i + j] += result[i] * factor[j];
+            result = std::move(next);
+        }
+        return result;
+    }
+
+    /**
+   * Finds the number of baby steps with the lowest depth, and among those
+   * the lowest number of non-scalar multiplications. With extraDepth > 0,
+   * schedules up to extraDepth levels deeper than the minimum are accepted
+   * if they need fewer non-scalar multiplications.
+   */
+    static Plan MakePlan(const std::vector<double>& coefficients, uint32_t extraDepth = 0) {
+        std::vector<double> coeffs = Trim(coefficients);
+        if (coeffs.size() < 2)
+            return Plan();
+
+        uint32_t degree = coeffs.size() - 1;
+        std::vector<Plan> plans;
+        for (uint32_t k = 1; k <= 2 * degree; k *= 2) {
+            PlanBackend backend;
+            Run(backend, coeffs, k);
+
+            Plan plan;
+            plan.babySteps      = k;
+            plan.depth          = backend.depth;
+            plan.nonScalarMults = backend.nonScalarMults;
+            plan.scalarMults    = backend.scalarMults;
+            plans.push_back(plan);
+        }
+
+        uint32_t minDepth = plans[0].depth;
+        for (const auto& plan : plans)
+            minDepth = std::min(minDepth, plan.depth);
+
+        Plan best;
+        bool found = false;
+        for (const auto& plan : plans) {
+            if (plan.depth > minDepth + extraDepth)
+                continue;
+            if (!found || plan.nonScalarMults < best.nonScalarMults ||
+                (plan.nonScalarMults == best.nonScalarMults && plan.depth < best.depth)) {
+                best  = plan;
+                found = true;
+            }
+        }
+        return best;
+    }
+
+    // degree after dropping zero leading coefficients, -1 for the zero polynomial
+    static int Degree(const std::vector<double>& coefficients) {
+        return static_cast<int>(Trim(coefficients).size()) - 1;
+    }
+
+    /**
+   * Runs the planned schedule on backend; the polynomial must have degree
+   * at least 1
+   */
+    template <class Backend>
+    static typename Backend::Value Evaluate(Backend& backend, const std::vector<double>& coefficients,
+                                            uint32_t extraDepth = 0) {
+        std::vector<double> coeffs = Trim(coefficients);
+        if (coeffs.size() < 2)
+            throw std::invalid_argument("PolySchedule: polynomial must have degree at least 1");
+
+        Plan plan = MakePlan(coeffs, extraDepth);
+        return Run(backend, coeffs, plan.babySteps).value;
+    }
+
+private:
+    // A piece of the result: either the plain constant c, or an encrypted value
+    template <class Value>
+    struct Term {
+        bool isConst = true;
+        double c     = 0.0;
+        Value value{};
+    };
+
+    // PlanBackend only tracks depth and counts
+    struct PlanValue {
+        uint32_t depth = 0;
+    };
+
+    struct PlanBackend {
+        using Value = PlanValue;
+
+        uint32_t depth          = 0;
+        uint32_t nonScalarMults = 0;
+        uint32_t scalarMults    = 0;
+
+        Value Input() {
+            return Value{0};
+        }
+        Value Mult(const Value& a, const Value& b) {
+            nonScalarMults++;
+            return Track(Value{std::max(a.depth, b.depth) + 1});
+        }
+        Value MultConst(const Value& a, double) {
+            scalarMults++;
+            return Track(Value{a.depth + 1});
+        }
+        Value Add(const Value& a, const Value& b) {
+            return Track(Value{std::max(a.depth, b.depth)});
+        }
+        Value AddConst(const Value& a, double) {
+            return a;
+        }
+
+    private:
+        Value Track(Value v) {
+            depth = std::max(depth, v.depth);
+            return v;
+        }
+    };
+
+    static std::vector<double> Trim(std::vector<double> coeffs) {
+        while (!coeffs.empty() && coeffs.back() == 0.0)
+            coeffs.pop_back();
+        return coeffs;
+    }
+
+    template <class Backend>
+    class Schedule {
+    public:
+        using Value = typename Backend::Value;
+
+        Schedule(Backend& backend, uint32_t k) : backend(backend), k(k) {
+            powers[1] = backend.Input();
+        }
+
+        // x^i, computed on demand as x^(2^t) * x^(i - 2^t) so that its depth is ceil(log2 i)
+        const Value& Power(uint32_t i) {
+            auto it = powers.find(i);
+            if (it != powers.end())
+                return it->second;
+
+            uint32_t high = 1;
+            while (high * 2 <= i)
+                high *= 2;
+
+            Value v;
+            if (high == i)
+                v = backend.Mult(Power(i / 2), Power(i / 2));
+            else
+                v = backend.Mult(Power(high), Power(i - high));
+            return powers[i] = std::move(v);
+        }
+
+        Term<Value> Eval(const std::vector<double>& coeffs, size_t begin, size_t end) {
+            size_t length = end - begin;
+
+            if (length <= k)
+                return Leaf(coeffs, begin, end);
+
+            // split at the largest giant step k * 2^j below length
+            uint32_t split = k;
+            while (static_cast<size_t>(split) * 2 < length)
+                split *= 2;
+
+            Term<Value> q = Eval(coeffs, begin + split, end);
+            Term<Value> r = Eval(coeffs, begin, begin + split);
+
+            Term<Value> result;
+            if (q.isConst) {
+                if (q.c == 0.0)
+                    return r;
+                result = Encrypted(q.c == 1.0 ? Power(split) : backend.MultConst(Power(split), q.c));
+            }
+            else {
+                result = Encrypted(backend.Mult(q.value, Power(split)));
+            }
+            return Combine(std::move(result), r);
+        }
+
+    private:
+        Term<Value> Leaf(const std::vector<double>& coeffs, size_t begin, size_t end) {
+            Term<Value> result;
+            result.c = coeffs[begin];
+            for (size_t i = begin + 1; i < end; i++) {
+                if (coeffs[i] == 0.0)
+                    continue;
+                uint32_t exponent = i - begin;
+                Value term = (coeffs[i] == 1.0) ? Power(exponent) : backend.MultConst(Power(exponent), coeffs[i]);
+                result.value   = result.isConst ? std::move(term) : backend.Add(result.value, term);
+                result.isConst = false;
+            }
+            // constants are added last, they cost no depth
+            if (!result.isConst && result.c != 0.0)
+                result.value = backend.AddConst(result.value, result.c);
+            return result;
+        }
+
+        Term<Value> Combine(Term<Value> a, const Term<Value>& b) {
+            if (!b.isConst)
+                a.value = backend.Add(a.value, b.value);
+            else if (b.c != 0.0)
+                a.value = backend.AddConst(a.value, b.c);
+            return a;
+        }
+
+        static Term<Value> Encrypted(Value v) {
+            Term<Value> t;
+            t.isConst = false;
+            t.value   = std::move(v);
+            return t;
+        }
+
+        Backend& backend;
+        uint32_t k;
+        std::map<uint32_t, Value> powers;
+    };
+
+    template <class Backend>
+    static Term<typename Backend::Value> Run(Backend& backend, const std::vector<double>& coeffs, uint32_t k) {
+        Schedule<Backend> schedule(backend, k);
+        return schedule.Eval(coeffs, 0, coeffs.size());
+    }
+};
+
+}  // namespace lbcrypto
+
+#endif
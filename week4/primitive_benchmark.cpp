@@ -0,0 +1,248 @@
+/*
+  Microbenchmarks of the CKKS primitives used in the week4 demos
+
+  demo 함수 안의 TIC/TOC 출력 대신, 기본 연산들을 ring dimension / depth / scaling technique /
+  key switching 방식 별로, 그리고 modulus chain 의 각 level 에서 반복 측정해서 JSON 으로 저장한다. 저장한 결과는
+  benchmark_compare 로 이전 결과 (baseline) 와 비교할 수 있다.
+
+  usage: primitive_benchmark [--ring 8192,16384] [--depth 1,3,5]
+                             [--scal FLEXIBLEAUTO,FIXEDAUTO,FIXEDMANUAL] [--ks HYBRID,BV]
+                             [--reps 20] [--out results.json]
+ */
+
+#define PROFILE
+
+#include "openfhe.h"
+#include "bench-fixture.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace lbcrypto;
+
+struct BenchmarkConfig {
+    std::vector<uint32_t> ringDims          = {8192, 16384};
+    std::vector<uint32_t> depths            = {1, 3, 5};
+    std::vector<ScalingTechnique> scalTechs = {FLEXIBLEAUTO, FIXEDAUTO, FIXEDMANUAL};
+    std::vector<KeySwitchTechnique> ksTechs = {HYBRID, BV};
+    uint32_t repetitions                    = 20;
+    std::string output                      = "primitive_benchmark.json";
+};
+
+struct BenchmarkResult {
+    std::string name;
+    std::string op;
+    std::string scalTech;
+    std::string ksTech;
+    uint32_t ringDim = 0;
+    uint32_t depth   = 0;
+    uint32_t level   = 0;  // levels consumed by the input, 0 for a fresh ciphertext
+    std::vector<double> samples;  // microseconds, one per repetition
+
+    double Mean() const {
+        double sum = 0;
+        for (double s : samples)
+            sum += s;
+        return sum / samples.size();
+    }
+
+    double Stddev() const {
+        double mean = Mean();
+        double sum  = 0;
+        for (double s : samples)
+            sum += (s - mean) * (s - mean);
+        return samples.size() > 1 ? std::sqrt(sum / (samples.size() - 1)) : 0;
+    }
+
+    // nearest-rank percentile
+    double Percentile(double p) const {
+        std::vector<double> sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+        size_t rank = static_cast<size_t>(std::ceil(p / 100 * sorted.size()));
+        return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+    }
+
+    // one object per line, which is what benchmark_compare reads
+    std::string ToJson() const {
+        std::ostringstream out;
+        out << "{\"name\": \"" << name << "\", \"op\": \"" << op << "\", \"scalTech\": \"" << scalTech
+            << "\", \"ksTech\": \"" << ksTech << "\", \"ringDim\": " << ringDim << ", \"depth\": " << depth
+            << ", \"level\": " << level << ", \"repetitions\": " << samples.size() << ", \"mean_us\": " << Mean()
+            << ", \"stddev_us\": " << Stddev() << ", \"min_us\": " << Percentile(0)
+            << ", \"p50_us\": " << Percentile(50) << ", \"p90_us\": " << Percentile(90)
+            << ", \"p99_us\": " << Percentile(99) << ", \"max_us\": " << Percentile(100) << "}";
+        return out.str();
+    }
+};
+
+BenchmarkConfig ParseArgs(int argc, char* argv[]);
+std::vector<BenchmarkResult> RunContext(uint32_t ringDim, uint32_t depth, ScalingTechnique scalTech,
+                                        KeySwitchTechnique ksTech, uint32_t repetitions);
+
+int main(int argc, char* argv[]) {
+    BenchmarkConfig config = ParseArgs(argc, argv);
+
+    std::vector<BenchmarkResult> results;
+    for (uint32_t ringDim : config.ringDims) {
+        for (uint32_t depth : config.depths) {
+            for (ScalingTechnique scalTech : config.scalTechs) {
+                for (KeySwitchTechnique ksTech : config.ksTechs) {
+                    std::cout << "N=" << ringDim << " depth=" << depth << " " << BenchFixture::ToString(scalTech)
+                              << " " << BenchFixture::ToString(ksTech) << std::endl;
+                    for (auto& r : RunContext(ringDim, depth, scalTech, ksTech, config.repetitions)) {
+                        std::cout << "  " << r.op << " level " << r.level << ": " << r.Mean() << " us (p50 " << r.Percentile(50) << ", p99 "
+                                  << r.Percentile(99) << ")" << std::endl;
+                        results.push_back(std::move(r));
+                    }
+                }
+            }
+        }
+    }
+
+    std::ofstream out(config.output);
+    out << "{\"benchmarks\": [" << std::endl;
+    for (size_t i = 0; i < results.size(); i++)
+        out << results[i].ToJson() << (i + 1 < results.size() ? "," : "") << std::endl;
+    out << "]}" << std::endl;
+
+    std::cout << results.size() << " benchmarks written to " << config.output << std::endl;
+    return 0;
+}
+
+std::vector<BenchmarkResult> RunContext(uint32_t ringDim, uint32_t depth, ScalingTechnique scalTech,
+                                        KeySwitchTechnique ksTech, uint32_t repetitions) {
+    CCParams<CryptoContextCKKSRNS> parameters;
+    parameters.SetMultiplicativeDepth(depth);
+    parameters.SetScalingModSize(50);
+    parameters.SetScalingTechnique(scalTech);
+    parameters.SetKeySwitchTechnique(ksTech);
+    parameters.SetRingDim(ringDim);
+    parameters.SetBatchSize(ringDim / 2);
+    // the ring dimension is swept directly, whether or not it is secure for the modulus
+    parameters.SetSecurityLevel(HEStd_NotSet);
+
+    CryptoContext<DCRTPoly> cc = GenCryptoContext(parameters);
+    std::vector<int32_t> hoistIndices = {1, 2, 3, 4, 5, 6, 7, 8};
+    BenchFixture fixture(cc, 1, ringDim / 2, hoistIndices, false);
+    const auto& keys             = fixture.GetKeys();
+    const std::vector<double>& x = fixture.GetPlainInputs()[0];
+    const uint32_t m             = cc->GetCyclotomicOrder();
+
+    std::vector<BenchmarkResult> results;
+    // every level that still allows a multiplication; the input is encoded at
+    // that level, which drops the same RNS limbs as rescaling down to it
+    // (with the scale FLEXIBLEAUTO expects there) without its noise
+    for (uint32_t level = 0; level < depth; level++) {
+        Plaintext ptxt = cc->MakeCKKSPackedPlaintext(x, 1, level);
+        auto c         = cc->Encrypt(keys.publicKey, ptxt);
+        auto cMult     = cc->EvalMult(c, c);
+
+        std::vector<std::pair<std::string, std::function<void()>>> ops = {
+            {"Encode", [&] { cc->MakeCKKSPackedPlaintext(x, 1, level); }},
+            {"Encrypt", [&] { cc->Encrypt(keys.publicKey, ptxt); }},
+            {"EvalAdd", [&] { cc->EvalAdd(c, c); }},
+            {"EvalMult", [&] { cc->EvalMult(c, c); }},
+            {"EvalRotate", [&] { cc->EvalRotate(c, 1); }},
+            {"HoistedRotate",
+             [&] {
+                 auto precomp = cc->EvalFastRotationPrecompute(c);
+                 for (int32_t index : hoistIndices)
+                     cc->EvalFastRotation(c, index, m, precomp);
+             }},
+            // OpenFHE decodes inside Decrypt
+            {"DecryptDecode",
+             [&] {
+                 Plaintext result;
+                 cc->Decrypt(keys.secretKey, c, &result);
+             }},
+        };
+        // with FLEXIBLEAUTO/FIXEDAUTO, Rescale is a no-op: OpenFHE rescales inside EvalMult
+        if (scalTech == FIXEDMANUAL)
+            ops.push_back({"Rescale", [&] { cc->Rescale(cMult); }});
+
+        for (auto& op : ops) {
+            BenchmarkResult r;
+            r.op       = op.first;
+            r.scalTech = BenchFixture::ToString(scalTech);
+            r.ksTech   = BenchFixture::ToString(ksTech);
+            r.ringDim  = ringDim;
+            r.depth    = depth;
+            r.level    = level;
+            r.name     = r.op + "/" + r.scalTech + "/" + r.ksTech + "/N=" + std::to_string(ringDim) + "/depth=" +
+                     std::to_string(depth) + "/level=" + std::to_string(level);
+
+            op.second();  // warm-up
+            TimeVar t;
+            for (uint32_t i = 0; i < repetitions; i++) {
+                TIC(t);
+                op.second();
+                double us = TOC_US(t);
+                // per rotation, to compare with EvalRotate
+                r.samples.push_back(r.op == "HoistedRotate" ? us / hoistIndices.size() : us);
+            }
+            results.push_back(std::move(r));
+        }
+    }
+    return results;
+}
+
+template <class T>
+std::vector<T> ParseList(const std::string& arg, const std::function<T(const std::string&)>& parse) {
+    std::vector<T> values;
+    std::stringstream in(arg);
+    std::string item;
+    while (std::getline(in, item, ','))
+        values.push_back(parse(item));
+    return values;
+}
+
+BenchmarkConfig ParseArgs(int argc, char* argv[]) {
+    const std::string usage =
+        "usage: primitive_benchmark [--ring 8192,16384] [--depth 1,3,5] "
+        "[--scal FLEXIBLEAUTO,FIXEDAUTO,FIXEDMANUAL] [--ks HYBRID,BV] [--reps 20] [--out results.json]";
+    BenchmarkConfig config;
+    auto toUint = [](const std::string& s) { return static_cast<uint32_t>(std::stoul(s)); };
+    auto toScal = [](const std::string& s) {
+        if (s == "FLEXIBLEAUTO")
+            return FLEXIBLEAUTO;
+        if (s == "FIXEDAUTO")
+            return FIXEDAUTO;
+        if (s == "FIXEDMANUAL")
+            return FIXEDMANUAL;
+        OPENFHE_THROW(config_error, "unknown scaling technique " + s);
+    };
+    auto toKs = [](const std::string& s) {
+        if (s == "HYBRID")
+            return HYBRID;
+        if (s == "BV")
+            return BV;
+        OPENFHE_THROW(config_error, "unknown key switching technique " + s);
+    };
+
+    for (int i = 1; i < argc; i += 2) {
+        std::string flag = argv[i];
+        if (i + 1 == argc)
+            OPENFHE_THROW(config_error, "option " + flag + " needs a value\n" + usage);
+        std::string arg = argv[i + 1];
+        if (flag == "--ring")
+            config.ringDims = ParseList<uint32_t>(arg, toUint);
+        else if (flag == "--depth")
+            config.depths = ParseList<uint32_t>(arg, toUint);
+        else if (flag == "--scal")
+            config.scalTechs = ParseList<ScalingTechnique>(arg, toScal);
+        else if (flag == "--ks")
+            config.ksTechs = ParseList<KeySwitchTechnique>(arg, toKs);
+        else if (flag == "--reps")
+            config.repetitions = toUint(arg);
+        else if (flag == "--out")
+            config.output = arg;
+        else
+            OPENFHE_THROW(config_error, "unknown option " + flag + "\n" + usage);
+    }
+    return config;
+}
@@ -0,0 +1,110 @@
+/*
+  Lazy relinearization
+
+  곱셈 결과 (원소 3개짜리 암호문) 를 바로 relinearize 하지 않고, 덧셈은 그대로 통과시킨 뒤
+  곱셈, rotation, 출력처럼 원소 2개가 꼭 필요한 곳에서 한 번만 relinearize 한다.
+ */
+
+#ifndef CAU_PRE_RELIN_SCHEDULER_H
+#define CAU_PRE_RELIN_SCHEDULER_H
+
+#include "openfhe.h"
+#include "circuit.h"
+
+#include <map>
+#include <vector>
+
+namespace lbcrypto {
+
+/**
+ * @brief RelinScheduler
+ *
+ * EvalMult always relinearizes, i.e. performs one key switch per product.
+ * When several products are added together before the next multiplication,
+ * one relinearization of the sum is enough: the sum of three-element
+ * ciphertexts is still a three-element ciphertext.
+ *
+ * Lazy() rewrites every MULT/SQUARE of a circuit as MULT_NO_RELIN, and puts
+ * a RELINEARIZE only where two elements are required:
+ *
+ * - before a ciphertext multiplication (keeps ciphertexts at three elements),
+ * - before a rotation (automorphism key switching expects two elements),
+ * - on the outputs.
+ *
+ * Additions, constant additions/multiplications and rescales all work on
+ * three-element ciphertexts. Each value is relinearized at most once.
+ */
+class RelinScheduler {
+public:
+    static Circuit Lazy(const Circuit& circuit) {
+        Circuit out;
+        out.SetSlots(circuit.GetSlots());
+
+        const auto& nodes = circuit.GetNodes();
+        std::vector<Circuit::Wire> wire(nodes.size());
+        std::map<Circuit::Wire, bool> extended;              // true for three-element values
+        std::map<Circuit::Wire, Circuit::Wire> relinearized;  // wire -> its relinearized version
+
+        auto relin = [&](Circuit::Wire w) {
+            if (!extended[w])
+                return w;
+            auto it = relinearized.find(w);
+            if (it == relinearized.end())
+                it = relinearized.emplace(w, out.Relinearize(w)).first;
+            return it->second;
+        };
+
+        for (size_t i = 0; i < nodes.size(); i++) {
+            const CircuitNode& node = nodes[i];
+            Circuit::Wire a         = node.inputs.empty() ? 0 : wire[node.inputs[0]];
+            Circuit::Wire b         = node.inputs.size() < 2 ? 0 : wire[node.inputs[1]];
+
+            switch (node.op) {
+                case CircuitOp::INPUT:
+                    wire[i] = out.Input();
+                    break;
+                case CircuitOp::MULT:
+                case CircuitOp::MULT_NO_RELIN:
+                    wire[i]           = out.MultNoRelin(relin(a), relin(b));
+                    extended[wire[i]] = true;
+                    break;
+                case CircuitOp::SQUARE:
+                    a                 = relin(a);
+                    wire[i]           = out.MultNoRelin(a, a);
+                    extended[wire[i]] = true;
+                    break;
+                case CircuitOp::RELINEARIZE:
+                    wire[i] = a;
+                    break;
+                case CircuitOp::ROTATE:
+                    wire[i] = out.Rotate(relin(a), node.index);
+                    break;
+                case CircuitOp::ADD:
+                case CircuitOp::SUB:
+                    wire[i]           = node.op == CircuitOp::ADD ? out.Add(a, b) : out.Sub(a, b);
+                    extended[wire[i]] = extended[a] || extended[b];
+                    break;
+                case CircuitOp::ADD_CONST:
+                    wire[i]           = out.AddConst(a, node.constant);
+                    extended[wire[i]] = extended[a];
+                    break;
+                case CircuitOp::MULT_CONST:
+                    wire[i]           = out.MultConst(a, node.constant);
+                    extended[wire[i]] = extended[a];
+                    break;
+                case CircuitOp::RESCALE:
+                    wire[i]           = out.Rescale(a);
+                    extended[wire[i]] = extended[a];
+                    break;
+            }
+        }
+
+        for (Circuit::Wire w : circuit.GetOutputs())
+            out.Output(relin(wire[w]));
+        return out;
+    }
+};
+
+}  // namespace lbcrypto
+
+#endif
@@ -0,0 +1,189 @@
+/*
+  Rescale placement for FIXEDMANUAL circuits
+
+  ManualRescaleDemo 처럼 연산마다 Rescale 을 붙이면 level 을 쓸데없이 소모하므로,
+  Rescale 을 곱셈 직전 (또는 scale 을 맞춰야 하는 덧셈 직전) 에만 넣도록 다시 배치한다.
+ */
+
+#ifndef CAU_PRE_RESCALE_OPTIMIZER_H
+#define CAU_PRE_RESCALE_OPTIMIZER_H
+
+#include "openfhe.h"
+#include "circuit.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace lbcrypto {
+
+/**
+ * Levels and rescales used by a FIXEDMANUAL circuit
+ */
+struct ManualCircuitStats {
+    // multiplicative depth the context must support (SetMultiplicativeDepth)
+    uint32_t depth    = 0;
+    uint32_t rescales = 0;
+};
+
+/**
+ * @brief RescaleOptimizer
+ *
+ * In FIXEDMANUAL every ciphertext carries a level (number of rescales so far)
+ * and a scaling degree (1 after encryption, the sum of the degrees after a
+ * multiplication, minus one after every rescale). A rescale is only needed
+ * when
+ *
+ * - a ciphertext of degree 2 or more goes into a multiplication, or
+ * - two ciphertexts of different degrees are added.
+ *
+ * Optimize() drops every RESCALE node of the input circuit and inserts them
+ * back at exactly these points, i.e. lazily, right before the multiplication
+ * that needs them. Sums of products are therefore rescaled once instead of
+ * once per product, additions and rotations never trigger a rescale, and a
+ * value used by several multiplications is rescaled only once.
+ */
+class RescaleOptimizer {
+public:
+    /**
+   * Returns the circuit with rescales placed only where they are needed.
+   * With rescaleOutputs, outputs are also brought back to degree 1.
+   */
+    static Circuit Optimize(const Circuit& circuit, bool rescaleOutputs = false) {
+        Circuit out;
+        out.SetSlots(circuit.GetSlots());
+
+        const auto& nodes = circuit.GetNodes();
+        std::vector<Circuit::Wire> wire(nodes.size());
+        std::map<Circuit::Wire, uint32_t> degree;
+        std::map<Circuit::Wire, Circuit::Wire> lowered;  // wire -> its rescaled version
+
+        // rescales w (once, whatever the number of consumers) until its degree is target
+        auto lower = [&](Circuit::Wire w, uint32_t target) {
+            while (degree[w] > target) {
+                auto it = lowered.find(w);
+                if (it == lowered.end()) {
+                    Circuit::Wire r = out.Rescale(w);
+                    degree[r]       = degree[w] - 1;
+                    it              = lowered.emplace(w, r).first;
+                }
+                w = it->second;
+            }
+            return w;
+        };
+
+        for (size_t i = 0; i < nodes.size(); i++) {
+            const CircuitNode& node = nodes[i];
+            Circuit::Wire a         = node.inputs.empty() ? 0 : wire[node.inputs[0]];
+            Circuit::Wire b         = node.inputs.size() < 2 ? 0 : wire[node.inputs[1]];
+
+            switch (node.op) {
+                case CircuitOp::INPUT:
+                    wire[i]         = out.Input();
+                    degree[wire[i]] = 1;
+                    break;
+                case CircuitOp::RESCALE:
+                    wire[i] = a;
+                    break;
+                case CircuitOp::MULT:
+                case CircuitOp::MULT_NO_RELIN:
+                    a               = lower(a, 1);
+                    b               = lower(b, 1);
+                    wire[i]         = node.op == CircuitOp::MULT ? out.Mult(a, b) : out.MultNoRelin(a, b);
+                    degree[wire[i]] = 2;
+                    break;
+                case CircuitOp::SQUARE:
+                    a               = lower(a, 1);
+                    wire[i]         = out.Square(a);
+                    degree[wire[i]] = 2;
+                    break;
+                case CircuitOp::MULT_CONST:
+                    a               = lower(a, 1);
+                    wire[i]         = out.MultConst(a, node.constant);
+                    degree[wire[i]] = 2;
+                    break;
+                case CircuitOp::ADD:
+                case CircuitOp::SUB: {
+                    uint32_t target = std::min(degree[a], degree[b]);
+                    a               = lower(a, target);
+                    b               = lower(b, target);
+                    wire[i]         = node.op == CircuitOp::ADD ? out.Add(a, b) : out.Sub(a, b);
+                    degree[wire[i]] = target;
+                    break;
+                }
+                case CircuitOp::ADD_CONST:
+                    wire[i]         = out.AddConst(a, node.constant);
+                    degree[wire[i]] = degree[a];
+                    break;
+                case CircuitOp::ROTATE:
+                    wire[i]         = out.Rotate(a, node.index);
+                    degree[wire[i]] = degree[a];
+                    break;
+                case CircuitOp::RELINEARIZE:
+                    wire[i]         = out.Relinearize(a);
+                    degree[wire[i]] = degree[a];
+                    break;
+            }
+        }
+
+        for (Circuit::Wire w : circuit.GetOutputs())
+            out.Output(rescaleOutputs ? lower(wire[w], 1) : wire[w]);
+        return out;
+    }
+
+    /**
+   * Depth and number of rescales of a FIXEDMANUAL circuit, taking its
+   * RESCALE nodes as they are
+   */
+    static ManualCircuitStats Analyze(const Circuit& circuit) {
+        const auto& nodes = circuit.GetNodes();
+        std::vector<uint32_t> level(nodes.size(), 0);
+        std::vector<uint32_t> degree(nodes.size(), 1);
+
+        ManualCircuitStats stats;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            const CircuitNode& node = nodes[i];
+            for (Circuit::Wire in : node.inputs)
+                level[i] = std::max(level[i], level[in]);
+
+            switch (node.op) {
+                case CircuitOp::INPUT:
+                    degree[i] = 1;
+                    break;
+                case CircuitOp::RESCALE:
+                    // rescaling a degree-1 ciphertext still drops a prime
+                    level[i]++;
+                    degree[i] = degree[node.inputs[0]] > 0 ? degree[node.inputs[0]] - 1 : 0;
+                    stats.rescales++;
+                    break;
+                case CircuitOp::MULT:
+                case CircuitOp::MULT_NO_RELIN:
+                    degree[i] = degree[node.inputs[0]] + degree[node.inputs[1]];
+                    break;
+                case CircuitOp::SQUARE:
+                    degree[i] = 2 * degree[node.inputs[0]];
+                    break;
+                case CircuitOp::MULT_CONST:
+                    degree[i] = degree[node.inputs[0]] + 1;
+                    break;
+                case CircuitOp::ADD:
+                case CircuitOp::SUB:
+                    degree[i] = std::max(degree[node.inputs[0]], degree[node.inputs[1]]);
+                    break;
+                case CircuitOp::ADD_CONST:
+                case CircuitOp::ROTATE:
+                case CircuitOp::RELINEARIZE:
+                    degree[i] = degree[node.inputs[0]];
+                    break;
+            }
+            // every outstanding scaling degree beyond the first needs a prime of its own
+            stats.depth = std::max(stats.depth, level[i] + std::max<uint32_t>(degree[i], 1) - 1);
+        }
+        return stats;
+    }
+};
+
+}  // namespace lbcrypto
+
+#endif
@@ -0,0 +1,53 @@
+/*
+  Many rotations of one ciphertext in a single call
+
+  FastRotationsDemo1/2 처럼 EvalFastRotationPrecompute 후 EvalFastRotation(c, k, M, cPrecomp)
+  를 인덱스마다 직접 부르던 것을 한 번의 호출로 묶고, 인덱스별 key switching 은 여러
+  스레드에 나눠서 실행한다.
+ */
+
+#ifndef CAU_PRE_ROTATE_MANY_H
+#define CAU_PRE_ROTATE_MANY_H
+
+#include "openfhe.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace lbcrypto {
+
+/**
+ * Returns ct rotated by every index (result[i] is the rotation by
+ * indices[i]); a rotation key must exist for every non-zero index.
+ *
+ * The digit decomposition of ct (the expensive, index-independent part of
+ * key switching) is computed once with EvalFastRotationPrecompute, and the
+ * per-index automorphisms and key products run in parallel with OpenMP, as
+ * OpenFHE does itself in EvalLinearTransform. With a single index this is
+ * a plain EvalRotate.
+ */
+inline std::vector<Ciphertext<DCRTPoly>> EvalRotateMany(const CryptoContext<DCRTPoly>& cc,
+                                                        ConstCiphertext<DCRTPoly> ct,
+                                                        const std::vector<int32_t>& indices) {
+    std::vector<Ciphertext<DCRTPoly>> result(indices.size());
+    if (indices.empty())
+        return result;
+
+    if (indices.size() == 1) {
+        result[0] = indices[0] == 0 ? ct->Clone() : cc->EvalRotate(ct, indices[0]);
+        return result;
+    }
+
+    const uint32_t m = cc->GetCyclotomicOrder();
+    auto precomp     = cc->EvalFastRotationPrecompute(ct);
+
+#pragma omp parallel for schedule(dynamic)
+    for (size_t i = 0; i < indices.size(); i++) {
+        result[i] = indices[i] == 0 ? ct->Clone() : cc->EvalFastRotation(ct, indices[i], m, precomp);
+    }
+    return result;
+}
+
+}  // namespace lbcrypto
+
+#endif
@@ -0,0 +1,325 @@
+/*
+  Rotation key-set planning with composed (hoisted) rotations
+
+  EvalRotateKeyGen(keys.secretKey, {1, 2, 3, 4, 5, 6, 7}) 처럼 필요한 rotation 마다 key 를
+  만들면 key 하나에 수 MB 씩 든다. 적은 수의 key (2의 거듭제곱, NAF 자릿수 등) 만 만들고
+  나머지 rotation 은 그 key 들의 rotation 을 이어 붙여서 계산한다.
+ */
+
+#ifndef CAU_PRE_ROTATION_PLANNER_H
+#define CAU_PRE_ROTATION_PLANNER_H
+
+#include "openfhe.h"
+#include "rotate-many.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace lbcrypto {
+
+/**
+ * A set of rotation keys and how every needed rotation is composed from it
+ */
+struct RotationKeySet {
+    std::string name;
+    // indices to pass to EvalRotateKeyGen, all in [1, slots)
+    std::vector<int32_t> keys;
+    // needed rotation (in [0, slots)) -> key rotations applied one after the other
+    std::map<int32_t, std::vector<int32_t>> steps;
+    uint32_t slots = 0;
+    // key switches to compute every needed rotation once, without sharing
+    uint32_t totalRotations = 0;
+    // key switches on the longest chain
+    uint32_t maxRotations = 0;
+    double memoryBytes    = 0;   // modeled size of the keys
+    double measuredMs     = -1;  // -1 if not measured
+
+    friend std::ostream& operator<<(std::ostream& out, const RotationKeySet& set) {
+        out << std::left << std::setw(16) << set.name << std::right << " keys=" << set.keys.size()
+            << " memory=" << std::fixed << std::setprecision(1) << set.memoryBytes / (1 << 20) << "MB"
+            << " rotations=" << set.totalRotations << " (max chain " << set.maxRotations << ")";
+        if (set.measuredMs >= 0)
+            out << " measured=" << std::setprecision(2) << set.measuredMs << "ms";
+        out << std::defaultfloat;
+        return out;
+    }
+};
+
+/**
+ * @brief RotationKeyPlanner
+ *
+ * Chooses which rotation keys to generate for a set of needed rotations.
+ * Slots are cyclic, so a rotation by r can be computed as any sequence of
+ * key rotations whose sum is r modulo the number of slots; each key rotation
+ * is one key switch. For a given key set, the shortest sequence for every
+ * needed rotation is found by a breadth-first search over Z_slots.
+ *
+ * Candidates:
+ *
+ * - "direct": one key per needed rotation (one key switch each);
+ * - "power-of-two": the powers of two appearing in the binary expansions;
+ * - "NAF": the signed powers of two appearing in the non-adjacent forms,
+ *   with -2^i generated as slots - 2^i, which never needs more digits than
+ *   binary;
+ * - "<basis>+k": the smaller of the two sets above plus direct keys for the
+ *   k rotations with the longest chains, trading memory for latency one key
+ *   at a time.
+ *
+ * Keys that no shortest chain uses are dropped from every set.
+ *
+ * EvalRotations() evaluates the chains as a trie: rotations sharing a prefix
+ * share its ciphertexts, and all rotations leaving the same ciphertext are
+ * hoisted together with EvalRotateMany.
+ */
+class RotationKeyPlanner {
+public:
+    static std::vector<RotationKeySet> Candidates(const std::vector<int32_t>& needed, uint32_t slots,
+                                                  double keyBytes) {
+        std::set<int32_t> targets;
+        for (int32_t r : needed) {
+            int32_t n = Normalize(r, slots);
+            if (n != 0)
+                targets.insert(n);
+        }
+
+        std::set<int32_t> direct(targets.begin(), targets.end());
+        std::set<int32_t> binary, naf;
+        for (int32_t r : targets) {
+            for (int32_t d : BinaryDigits(r))
+                binary.insert(d);
+            for (int32_t d : NafDigits(r, slots))
+                if (Normalize(d, slots) != 0)
+                    naf.insert(Normalize(d, slots));
+        }
+
+        std::vector<RotationKeySet> candidates;
+        candidates.push_back(Build("direct", direct, targets, slots, keyBytes));
+        candidates.push_back(Build("power-of-two", binary, targets, slots, keyBytes));
+        candidates.push_back(Build("NAF", naf, targets, slots, keyBytes));
+
+        // starting from the smaller basis, add direct keys for the longest chains one at a time
+        const RotationKeySet& basis =
+            candidates[2].keys.size() < candidates[1].keys.size() ? candidates[2] : candidates[1];
+        std::string basisName = basis.name;
+        std::set<int32_t> mixed(basis.keys.begin(), basis.keys.end());
+        for (uint32_t k = 1;; k++) {
+            const RotationKeySet& last = candidates.back();
+            int32_t longest            = 0;
+            size_t longestSteps        = 1;
+            for (const auto& entry : last.steps) {
+                if (entry.second.size() > longestSteps) {
+                    longest      = entry.first;
+                    longestSteps = entry.second.size();
+                }
+            }
+            if (longest == 0)
+                break;
+            mixed.insert(longest);
+            RotationKeySet next = Build(basisName + "+" + std::to_string(k), mixed, targets, slots, keyBytes);
+            mixed               = std::set<int32_t>(next.keys.begin(), next.keys.end());
+            candidates.push_back(std::move(next));
+        }
+        return candidates;
+    }
+
+    /**
+   * The candidate with the fewest key switches whose keys fit in
+   * memoryBudget bytes (fewer keys on ties); the smallest one if none fits
+   */
+    static RotationKeySet Plan(const std::vector<int32_t>& needed, uint32_t slots, double keyBytes,
+                               double memoryBudget) {
+        std::vector<RotationKeySet> candidates = Candidates(needed, slots, keyBytes);
+
+        const RotationKeySet* best = nullptr;
+        for (const auto& set : candidates) {
+            if (set.memoryBytes > memoryBudget)
+                continue;
+            if (!best || set.totalRotations < best->totalRotations ||
+                (set.totalRotations == best->totalRotations && set.keys.size() < best->keys.size()))
+                best = &set;
+        }
+        if (!best) {
+            for (const auto& set : candidates)
+                if (!best || set.memoryBytes < best->memoryBytes)
+                    best = &set;
+        }
+        return *best;
+    }
+
+    /**
+   * Modeled size in bytes of one rotation key of cc: two polynomials per
+   * key switching digit, over Q*P for HYBRID and over Q for BV
+   */
+    static double KeyBytes(const CryptoContext<DCRTPoly>& cc) {
+        const auto cryptoParams = std::dynamic_pointer_cast<CryptoParametersRNS>(cc->GetCryptoParameters());
+        const auto paramsQ      = cc->GetElementParams()->GetParams();
+        double n                = cc->GetRingDimension();
+        double numQ             = paramsQ.size();
+
+        if (cryptoParams->GetKeySwitchTechnique() == HYBRID) {
+            double numQP = cryptoParams->GetParamsQP()->GetParams().size();
+            return cryptoParams->GetNumPartQ() * 2 * numQP * n * sizeof(uint64_t);
+        }
+
+        uint32_t digitSize = cryptoParams->GetDigitSize();
+        double digits      = 0;
+        for (const auto& q : paramsQ)
+            digits += digitSize == 0 ? 1 : std::ceil(static_cast<double>(q->GetModulus().GetMSB()) / digitSize);
+        return digits * 2 * numQ * n * sizeof(uint64_t);
+    }
+
+    /**
+   * ct rotated by every index, using only the keys of set. Every index must
+   * be one of the rotations the set was planned for (or 0).
+   */
+    static std::map<int32_t, Ciphertext<DCRTPoly>> EvalRotations(const CryptoContext<DCRTPoly>& cc,
+                                                                ConstCiphertext<DCRTPoly> ct,
+                                                                const RotationKeySet& set,
+                                                                const std::vector<int32_t>& indices) {
+        // trie of the chains; node 0 is ct itself
+        std::vector<TrieNode> trie(1);
+        std::map<int32_t, size_t> leaf;
+        for (int32_t index : indices) {
+            int32_t r = Normalize(index, set.slots);
+            size_t at = 0;
+            if (r != 0) {
+                auto it = set.steps.find(r);
+                if (it == set.steps.end())
+                    OPENFHE_THROW(config_error, "RotationKeyPlanner: rotation " + std::to_string(index) +
+                                                    " was not planned for this key set");
+                for (int32_t key : it->second) {
+                    auto child = trie[at].children.find(key);
+                    if (child != trie[at].children.end()) {
+                        at = child->second;
+                        continue;
+                    }
+                    trie.push_back(TrieNode());
+                    trie[at].children[key] = trie.size() - 1;
+                    at                     = trie.size() - 1;
+                }
+            }
+            leaf[index] = at;
+        }
+
+        // nodes are created after their parents, so one pass in order is enough
+        trie[0].value = ct->Clone();
+        for (size_t i = 0; i < trie.size(); i++) {
+            std::vector<int32_t> keys;
+            for (const auto& child : trie[i].children)
+                keys.push_back(child.first);
+
+            auto rotated = EvalRotateMany(cc, trie[i].value, keys);
+            size_t k     = 0;
+            for (const auto& child : trie[i].children)
+                trie[child.second].value = rotated[k++];
+        }
+
+        std::map<int32_t, Ciphertext<DCRTPoly>> result;
+        for (const auto& entry : leaf)
+            result[entry.first] = trie[entry.second].value;
+        return result;
+    }
+
+    static Ciphertext<DCRTPoly> EvalRotate(const CryptoContext<DCRTPoly>& cc, ConstCiphertext<DCRTPoly> ct,
+                                           const RotationKeySet& set, int32_t index) {
+        return EvalRotations(cc, ct, set, {index})[index];
+    }
+
+    static int32_t Normalize(int32_t r, uint32_t slots) {
+        int32_t s = static_cast<int32_t>(slots);
+        return ((r % s) + s) % s;
+    }
+
+private:
+    struct TrieNode {
+        Ciphertext<DCRTPoly> value;
+        std::map<int32_t, size_t> children;  // key -> node
+    };
+
+    static std::vector<int32_t> BinaryDigits(int32_t r) {
+        std::vector<int32_t> digits;
+        for (int32_t bit = 1; r != 0; bit <<= 1, r >>= 1)
+            if (r & 1)
+                digits.push_back(bit);
+        return digits;
+    }
+
+    // non-adjacent form of r, or of r - slots if that one is shorter
+    static std::vector<int32_t> NafDigits(int32_t r, uint32_t slots) {
+        auto naf = [](int32_t v) {
+            std::vector<int32_t> digits;
+            for (int32_t bit = 1; v != 0; bit <<= 1, v /= 2) {
+                if (v & 1) {
+                    int32_t d = 2 - (((v % 4) + 4) % 4);  // +1 or -1
+                    digits.push_back(d * bit);
+                    v -= d;
+                }
+            }
+            return digits;
+        };
+        std::vector<int32_t> a = naf(r);
+        std::vector<int32_t> b = naf(r - static_cast<int32_t>(slots));
+        return b.size() < a.size() ? b : a;
+    }
+
+    // shortest chains of keys for every target, by BFS over Z_slots; every
+    // target must be a sum of keys modulo slots, which the digit expansions
+    // above always are
+    static RotationKeySet Build(const std::string& name, const std::set<int32_t>& keys,
+                                const std::set<int32_t>& targets, uint32_t slots, double keyBytes) {
+        RotationKeySet set;
+        set.name        = name;
+        set.slots       = slots;
+        set.keys        = std::vector<int32_t>(keys.begin(), keys.end());
+
+        std::vector<int32_t> via(slots, -1);  // key used to reach r
+        std::vector<int32_t> from(slots, -1);
+        std::vector<int32_t> queue = {0};
+        via[0]                     = 0;
+        for (size_t head = 0; head < queue.size(); head++) {
+            int32_t r = queue[head];
+            for (int32_t key : set.keys) {
+                int32_t next = Normalize(r + key, slots);
+                if (via[next] < 0) {
+                    via[next]  = key;
+                    from[next] = r;
+                    queue.push_back(next);
+                }
+            }
+        }
+
+        for (int32_t r : targets) {
+            // keys sharing a factor with slots only reach its multiples
+            if (via[r] < 0)
+                OPENFHE_THROW(config_error, "RotationKeyPlanner: rotation " + std::to_string(r) +
+                                                " cannot be composed from the keys of " + name);
+            std::vector<int32_t> chain;
+            for (int32_t at = r; at != 0; at = from[at])
+                chain.push_back(via[at]);
+            // largest keys first, so that chains share prefixes in EvalRotations
+            std::sort(chain.rbegin(), chain.rend());
+            set.totalRotations += chain.size();
+            set.maxRotations = std::max<uint32_t>(set.maxRotations, chain.size());
+            set.steps[r]     = std::move(chain);
+        }
+
+        // keys no chain uses are not worth generating
+        std::set<int32_t> used;
+        for (const auto& entry : set.steps)
+            used.insert(entry.second.begin(), entry.second.end());
+        set.keys        = std::vector<int32_t>(used.begin(), used.end());
+        set.memoryBytes = keyBytes * used.size();
+        return set;
+    }
+};
+
+}  // namespace lbcrypto
+
+#endif
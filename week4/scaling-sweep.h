@@ -0,0 +1,176 @@
+/*
+  Precision / latency sweep over scaling techniques and scaling mod sizes
+
+  AutomaticRescaleDemo(FLEXIBLEAUTO), AutomaticRescaleDemo(FIXEDAUTO), ManualRescaleDemo(FIXEDMANUAL)
+  의 결과를 눈으로 비교하는 대신, 같은 회로를 scaling technique 와 SetScalingModSize 별로
+  돌려서 지연 시간, 메모리, 정밀도를 재고 Pareto frontier 를 표 / CSV 로 낸다.
+ */
+
+#ifndef CAU_PRE_SCALING_SWEEP_H
+#define CAU_PRE_SCALING_SWEEP_H
+
+#include "openfhe.h"
+#include "circuit.h"
+#include "bench-fixture.h"
+#include "rescale-optimizer.h"
+#include "rotation-planner.h"
+
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace lbcrypto {
+
+/**
+ * One (scaling technique, scaling mod size) configuration and what it
+ * measured on the circuit
+ */
+struct ScalingPoint {
+    ScalingTechnique scalTech = FLEXIBLEAUTO;
+    uint32_t scalingModSize   = 0;
+    uint32_t depth            = 0;  // multiplicative depth the context was built with
+    uint32_t ringDim          = 0;
+    double latencyMs          = 0;  // encrypt + circuit + decrypt, one run
+    double memoryBytes        = 0;  // modeled: evaluation keys and one fresh ciphertext per input
+    double precisionBits      = 0;  // -log2 of the largest error on the circuit outputs
+    bool pareto               = false;
+
+    static std::string CsvHeader() {
+        return "scalTech,scalingModSize,depth,ringDim,latencyMs,memoryMB,precisionBits,pareto";
+    }
+
+    std::string ToCsv() const {
+        std::ostringstream out;
+        out << BenchFixture::ToString(scalTech) << "," << scalingModSize << "," << depth << "," << ringDim << ","
+            << latencyMs << "," << memoryBytes / (1 << 20) << "," << precisionBits << "," << (pareto ? 1 : 0);
+        return out.str();
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, const ScalingPoint& p) {
+        out << std::left << std::setw(13) << BenchFixture::ToString(p.scalTech) << std::right << " scalingModSize="
+            << std::setw(2) << p.scalingModSize << " depth=" << p.depth << " N=" << std::setw(5) << p.ringDim
+            << std::fixed << std::setprecision(3) << " latency=" << p.latencyMs << "ms memory=" << std::setprecision(1)
+            << p.memoryBytes / (1 << 20) << "MB precision=" << p.precisionBits << " bits" << (p.pareto ? " *" : "")
+            << std::defaultfloat;
+        return out;
+    }
+};
+
+/**
+ * @brief ScalingSweep
+ *
+ * Sweep() builds a context for every scaling technique and scaling mod
+ * size, keeping the other CCParams (security level, batch size, key
+ * switching) as given. The multiplicative depth is the one the circuit
+ * needs under that technique: Circuit::GetDepth() for the automatic modes,
+ * and for FIXEDMANUAL the depth of the circuit after
+ * RescaleOptimizer::Optimize(), which also places the rescales (RESCALE
+ * nodes are no-ops in the automatic modes).
+ *
+ * Every point runs the circuit on random inputs in [-1, 1] and compares it
+ * with Circuit::EvaluatePlain(). A point is on the Pareto frontier if no
+ * other point is at least as good in latency, memory and precision and
+ * better in one of them. Configurations OpenFHE rejects (e.g. a scaling
+ * mod size too large for FLEXIBLEAUTO) are left out.
+ */
+class ScalingSweep {
+public:
+    static std::vector<ScalingPoint> Sweep(const Circuit& circuit, const CCParams<CryptoContextCKKSRNS>& parameters,
+                                           const std::vector<ScalingTechnique>& scalTechs = {FLEXIBLEAUTO, FIXEDAUTO,
+                                                                                             FIXEDMANUAL},
+                                           const std::vector<uint32_t>& scalingModSizes = {30, 35, 40, 45, 50, 55},
+                                           uint32_t numRuns                             = 5) {
+        Circuit manual                = RescaleOptimizer::Optimize(circuit, true);
+        const uint32_t manualDepth    = RescaleOptimizer::Analyze(manual).depth;
+        const uint32_t automaticDepth = circuit.GetDepth();
+
+        std::vector<ScalingPoint> points;
+        for (ScalingTechnique scalTech : scalTechs) {
+            const Circuit& run = scalTech == FIXEDMANUAL ? manual : circuit;
+            for (uint32_t scalingModSize : scalingModSizes) {
+                ScalingPoint p;
+                p.scalTech       = scalTech;
+                p.scalingModSize = scalingModSize;
+                p.depth          = scalTech == FIXEDMANUAL ? manualDepth : automaticDepth;
+
+                CCParams<CryptoContextCKKSRNS> candidate = parameters;
+                candidate.SetScalingTechnique(scalTech);
+                candidate.SetScalingModSize(scalingModSize);
+                candidate.SetMultiplicativeDepth(p.depth);
+
+                CryptoContext<DCRTPoly> cc;
+                try {
+                    cc = GenCryptoContext(candidate);
+                }
+                catch (const std::exception&) {
+                    continue;
+                }
+                MeasurePoint(run, cc, p, parameters.GetBatchSize(), numRuns);
+                points.push_back(p);
+            }
+        }
+
+        BenchFixture::MarkPareto(points, [](const ScalingPoint& p) {
+            return std::vector<double>{p.latencyMs, p.memoryBytes, -p.precisionBits};
+        });
+        return points;
+    }
+
+    /**
+   * The lowest-latency point with at least minPrecisionBits (less memory
+   * on ties), or nullptr if no point is precise enough
+   */
+    static const ScalingPoint* Cheapest(const std::vector<ScalingPoint>& points, double minPrecisionBits) {
+        const ScalingPoint* best = nullptr;
+        for (const auto& p : points) {
+            if (p.precisionBits < minPrecisionBits)
+                continue;
+            if (!best || p.latencyMs < best->latencyMs ||
+                (p.latencyMs == best->latencyMs && p.memoryBytes < best->memoryBytes))
+                best = &p;
+        }
+        return best;
+    }
+
+    /**
+   * Writes the points as CSV, with a header line; frontierOnly keeps only
+   * the Pareto points
+   */
+    static void WriteCsv(std::ostream& out, const std::vector<ScalingPoint>& points, bool frontierOnly = false) {
+        out << ScalingPoint::CsvHeader() << std::endl;
+        for (const auto& p : points)
+            if (!frontierOnly || p.pareto)
+                out << p.ToCsv() << std::endl;
+    }
+
+private:
+    static void MeasurePoint(const Circuit& circuit, const CryptoContext<DCRTPoly>& cc, ScalingPoint& p,
+                             uint32_t batchSize, uint32_t numRuns) {
+        std::vector<int32_t> rotIndices = circuit.GetRotationIndices();
+        // inputs are encrypted inside the timed loop
+        BenchFixture fixture(cc, circuit.GetNumInputs(), batchSize, rotIndices, false);
+        p.ringDim = cc->GetRingDimension();
+
+        // relinearization key + rotation keys + fresh ciphertexts (two polynomials over Q)
+        const double numQ    = cc->GetElementParams()->GetParams().size();
+        const double ctBytes = 2 * numQ * p.ringDim * sizeof(uint64_t);
+        p.memoryBytes =
+            (1 + rotIndices.size()) * RotationKeyPlanner::KeyBytes(cc) + circuit.GetNumInputs() * ctBytes;
+
+        std::vector<Plaintext> results;
+        p.latencyMs = BenchFixture::TimeMs(numRuns, [&] {
+            auto outputs = circuit.Evaluate(cc, fixture.EncryptInputs());
+            results.assign(outputs.size(), nullptr);
+            for (size_t o = 0; o < outputs.size(); o++)
+                cc->Decrypt(fixture.GetKeys().secretKey, outputs[o], &results[o]);
+        });
+        p.precisionBits = fixture.PrecisionBits(circuit, results);
+    }
+};
+
+}  // namespace lbcrypto
+
+#endif
@@ -0,0 +1,176 @@
+/*
+  Packing long input streams into full-width CKKS ciphertexts
+
+  week4_task / week6_task 처럼 암호문 하나에 값 8개만 넣으면 N/2 개 slot 대부분이 비어 있다.
+  입력 스트림을 slot 수만큼씩 잘라 꽉 채운 암호문들로 만들고, 회로를 ⌈n/slots⌉ 개 암호문에
+  돌린 뒤 출력을 원래 순서대로 다시 이어 붙인다.
+ */
+
+#ifndef CAU_PRE_SLOT_PACKER_H
+#define CAU_PRE_SLOT_PACKER_H
+
+#include "openfhe.h"
+#include "circuit.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace lbcrypto {
+
+/**
+ * Sizes and timings of one SlotPacker::Evaluate call
+ */
+struct PackingReport {
+    size_t values      = 0;  // per input stream
+    size_t ciphertexts = 0;  // per input stream
+    uint32_t slots     = 0;
+    double encryptMs   = 0;  // encode + encrypt
+    double evalMs      = 0;
+    double decryptMs   = 0;  // decrypt + decode + unpack
+
+    double TotalMs() const {
+        return encryptMs + evalMs + decryptMs;
+    }
+
+    double ValuesPerSecond() const {
+        return TotalMs() > 0 ? values / TotalMs() * 1000 : 0;
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, const PackingReport& r) {
+        out << r.values << " values in " << r.ciphertexts << " ciphertexts of " << r.slots << " slots: "
+            << std::fixed << std::setprecision(1) << "encrypt " << r.encryptMs << "ms, eval " << r.evalMs
+            << "ms, decrypt " << r.decryptMs << "ms, " << std::setprecision(0) << r.ValuesPerSecond()
+            << " values/s" << std::defaultfloat;
+        return out;
+    }
+};
+
+/**
+ * @brief SlotPacker
+ *
+ * Pack() cuts a stream of n values into ceil(n / slots) plaintexts of
+ * slots values each, the last one padded with zeros, and Unpack() puts the
+ * decrypted outputs back together in stream order. slots is the batch size
+ * of the context (N/2 when it was not set).
+ *
+ * Evaluate() runs a circuit over streams: input i of the circuit is stream
+ * i, all streams have the same length, and output j of the result is the
+ * stream of circuit output j. Element-wise circuits give exactly the
+ * per-value result. A ROTATE node rotates each full-width ciphertext, so it
+ * moves values between neighbours within a chunk of slots values, and the
+ * chunk boundaries depend on slots.
+ */
+class SlotPacker {
+public:
+    SlotPacker(const CryptoContext<DCRTPoly>& cc, const PublicKey<DCRTPoly>& publicKey,
+               const PrivateKey<DCRTPoly>& secretKey)
+        : m_cc(cc), m_publicKey(publicKey), m_secretKey(secretKey) {
+        m_slots = cc->GetEncodingParams()->GetBatchSize();
+        if (m_slots == 0)
+            m_slots = cc->GetRingDimension() / 2;
+    }
+
+    uint32_t GetSlots() const {
+        return m_slots;
+    }
+
+    size_t NumCiphertexts(size_t numValues) const {
+        return (numValues + m_slots - 1) / m_slots;
+    }
+
+    std::vector<Plaintext> Pack(const std::vector<double>& stream) const {
+        std::vector<Plaintext> packed;
+        packed.reserve(NumCiphertexts(stream.size()));
+        std::vector<double> chunk(m_slots);
+        for (size_t begin = 0; begin < stream.size(); begin += m_slots) {
+            size_t end = std::min(stream.size(), begin + m_slots);
+            std::copy(stream.begin() + begin, stream.begin() + end, chunk.begin());
+            std::fill(chunk.begin() + (end - begin), chunk.end(), 0.0);
+            packed.push_back(m_cc->MakeCKKSPackedPlaintext(chunk));
+        }
+        return packed;
+    }
+
+    std::vector<Ciphertext<DCRTPoly>> Encrypt(const std::vector<double>& stream) const {
+        std::vector<Ciphertext<DCRTPoly>> encrypted;
+        for (const auto& ptxt : Pack(stream))
+            encrypted.push_back(m_cc->Encrypt(m_publicKey, ptxt));
+        return encrypted;
+    }
+
+    /**
+   * Decrypts and concatenates the ciphertexts, keeping the first numValues
+   */
+    std::vector<double> Unpack(const std::vector<Ciphertext<DCRTPoly>>& encrypted, size_t numValues) const {
+        std::vector<double> stream;
+        stream.reserve(numValues);
+        for (const auto& ct : encrypted) {
+            Plaintext result;
+            m_cc->Decrypt(m_secretKey, ct, &result);
+            result->SetLength(m_slots);
+            std::vector<double> values = result->GetRealPackedValue();
+            size_t take = std::min<size_t>(numValues - stream.size(), values.size());
+            stream.insert(stream.end(), values.begin(), values.begin() + take);
+        }
+        return stream;
+    }
+
+    std::vector<std::vector<double>> Evaluate(const Circuit& circuit, const std::vector<std::vector<double>>& streams,
+                                              PackingReport* report = nullptr) const {
+        if (streams.size() != circuit.GetNumInputs())
+            OPENFHE_THROW(config_error, "SlotPacker: one stream per circuit input is needed");
+        const size_t numValues = streams.empty() ? 0 : streams[0].size();
+        for (const auto& stream : streams)
+            if (stream.size() != numValues)
+                OPENFHE_THROW(config_error, "SlotPacker: all streams must have the same length");
+
+        TimeVar t;
+        PackingReport r;
+        r.values      = numValues;
+        r.ciphertexts = NumCiphertexts(numValues);
+        r.slots       = m_slots;
+
+        // inputs[c][i]: chunk c of stream i
+        TIC(t);
+        std::vector<std::vector<Ciphertext<DCRTPoly>>> inputs(r.ciphertexts);
+        for (const auto& stream : streams) {
+            auto encrypted = Encrypt(stream);
+            for (size_t c = 0; c < encrypted.size(); c++)
+                inputs[c].push_back(encrypted[c]);
+        }
+        r.encryptMs = TOC(t);
+
+        // outputs[j][c]: chunk c of output j
+        TIC(t);
+        std::vector<std::vector<Ciphertext<DCRTPoly>>> outputs(circuit.GetOutputs().size());
+        for (size_t c = 0; c < inputs.size(); c++) {
+            auto chunkOutputs = circuit.Evaluate(m_cc, inputs[c]);
+            for (size_t j = 0; j < chunkOutputs.size(); j++)
+                outputs[j].push_back(chunkOutputs[j]);
+        }
+        r.evalMs = TOC(t);
+
+        TIC(t);
+        std::vector<std::vector<double>> result;
+        for (const auto& output : outputs)
+            result.push_back(Unpack(output, numValues));
+        r.decryptMs = TOC(t);
+
+        if (report)
+            *report = r;
+        return result;
+    }
+
+private:
+    CryptoContext<DCRTPoly> m_cc;
+    PublicKey<DCRTPoly> m_publicKey;
+    PrivateKey<DCRTPoly> m_secretKey;
+    uint32_t m_slots;
+};
+
+}  // namespace lbcrypto
+
+#endif
@@ -0,0 +1,136 @@
+/*
+  Window sums over slots with few rotations
+
+  FastRotationsDemo1 의 c + cRot1 + ... + cRot7 처럼 창 크기만큼 rotation 하지 않고,
+  2의 거듭제곱 창은 log2(n) 번의 rotate-and-add 로, 그 외의 창은 baby-step giant-step
+  (hoisting) 으로 더한다.
+ */
+
+#ifndef CAU_PRE_SLOT_SUM_H
+#define CAU_PRE_SLOT_SUM_H
+
+#include "openfhe.h"
+#include "rotate-many.h"
+
+#include <cmath>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+namespace lbcrypto {
+
+/**
+ * @brief SlotSum
+ *
+ * EvalWindowSum(ct, n, stride) puts in every slot i
+ *
+ *   ct[i] + ct[i + stride] + ... + ct[i + (n-1) stride]   (indices cyclic)
+ *
+ * so stride 1 sums n consecutive slots, a larger stride sums one column of
+ * a row-major matrix, and n = slots (stride 1) is the full sum in every
+ * slot.
+ *
+ * - n a power of two: log2(n) sequential steps acc += Rotate(acc, stride 2^k);
+ * - otherwise, with g = ceil(sqrt(n)) and n = h g + r: the baby sum
+ *   B = sum_{j<g} Rotate(ct, j stride) and its prefix of r terms, then
+ *   sum_{i<h} Rotate(B, i g stride) plus the prefix rotated by h g stride.
+ *   Baby and giant rotations are each hoisted in one EvalRotateMany, so
+ *   about 2 sqrt(n) rotations in two parallel batches.
+ *
+ * RotationIndices() lists the keys to pass to EvalRotateKeyGen.
+ */
+class SlotSum {
+public:
+    static std::vector<int32_t> RotationIndices(uint32_t n, uint32_t stride = 1) {
+        std::set<int32_t> indices;
+        const int32_t s = static_cast<int32_t>(stride);
+        if (n <= 1)
+            return {};
+
+        if (IsPowerOfTwo(n)) {
+            for (uint32_t step = 1; step < n; step *= 2)
+                indices.insert(s * static_cast<int32_t>(step));
+        }
+        else {
+            uint32_t g = BabySteps(n);
+            uint32_t h = n / g;
+            uint32_t r = n % g;
+            for (uint32_t j = 1; j < g; j++)
+                indices.insert(s * static_cast<int32_t>(j));
+            for (uint32_t i = 1; i < h; i++)
+                indices.insert(s * static_cast<int32_t>(i * g));
+            if (r > 0)
+                indices.insert(s * static_cast<int32_t>(h * g));
+        }
+        return std::vector<int32_t>(indices.begin(), indices.end());
+    }
+
+    static Ciphertext<DCRTPoly> EvalWindowSum(const CryptoContext<DCRTPoly>& cc, ConstCiphertext<DCRTPoly> ct,
+                                              uint32_t n, uint32_t stride = 1) {
+        if (n == 0)
+            OPENFHE_THROW(config_error, "SlotSum: window size must be at least 1");
+        if (n == 1)
+            return ct->Clone();
+
+        const int32_t s = static_cast<int32_t>(stride);
+
+        if (IsPowerOfTwo(n)) {
+            auto acc = cc->EvalAdd(ct, cc->EvalRotate(ct, s));
+            for (uint32_t step = 2; step < n; step *= 2)
+                cc->EvalAddInPlace(acc, cc->EvalRotate(acc, s * static_cast<int32_t>(step)));
+            return acc;
+        }
+
+        uint32_t g = BabySteps(n);
+        uint32_t h = n / g;
+        uint32_t r = n % g;
+
+        // baby steps: B = ct + Rotate(ct, s) + ... + Rotate(ct, (g-1) s), prefix = its first r terms
+        std::vector<int32_t> babyIndices;
+        for (uint32_t j = 1; j < g; j++)
+            babyIndices.push_back(s * static_cast<int32_t>(j));
+        auto baby = EvalRotateMany(cc, ct, babyIndices);
+
+        Ciphertext<DCRTPoly> babySum = ct->Clone();
+        Ciphertext<DCRTPoly> prefix;
+        for (uint32_t j = 1; j < g; j++) {
+            if (j == r)
+                prefix = babySum->Clone();
+            cc->EvalAddInPlace(babySum, baby[j - 1]);
+        }
+
+        // giant steps
+        std::vector<int32_t> giantIndices;
+        for (uint32_t i = 1; i < h; i++)
+            giantIndices.push_back(s * static_cast<int32_t>(i * g));
+        auto giant = EvalRotateMany(cc, babySum, giantIndices);
+
+        auto acc = babySum;
+        for (const auto& rotated : giant)
+            cc->EvalAddInPlace(acc, rotated);
+        if (r > 0)
+            cc->EvalAddInPlace(acc, cc->EvalRotate(prefix, s * static_cast<int32_t>(h * g)));
+        return acc;
+    }
+
+    /**
+   * Sum of all slots, in every slot
+   */
+    static Ciphertext<DCRTPoly> EvalFullSum(const CryptoContext<DCRTPoly>& cc, ConstCiphertext<DCRTPoly> ct,
+                                            uint32_t slots) {
+        return EvalWindowSum(cc, ct, slots, 1);
+    }
+
+private:
+    static bool IsPowerOfTwo(uint32_t n) {
+        return n && !(n & (n - 1));
+    }
+
+    static uint32_t BabySteps(uint32_t n) {
+        return static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(n))));
+    }
+};
+
+}  // namespace lbcrypto
+
+#endif
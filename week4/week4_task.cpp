@@ -2,6 +2,30 @@
 #define PROFILE
 
 #include "openfhe.h"
+#include "poly-eval.h"
+#include "circuit.h"
+#include "param-planner.h"
+#include "rescale-optimizer.h"
+#include "relin-scheduler.h"
+#include "constant-cache.h"
+#include "mult-accumulate.h"
+#include "rotation-planner.h"
+#include "dnum-tuner.h"
+#include "rotate-many.h"
+#include "slot-sum.h"
+#include "digit-size-tuner.h"
+#include "scaling-sweep.h"
+#include "slot-packer.h"
+#include "batch-executor.h"
+#include "dag-scheduler.h"
+#include "key-store.h"
+#include "context-registry.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
 
 using namespace lbcrypto;
 
@@ -11,14 +35,100 @@ void HybridKeySwitchingDemo1();
 void HybridKeySwitchingDemo2();
 void FastRotationsDemo1();
 void FastRotationsDemo2();
-
+void ParameterPlannerDemo();
+void RescaleOptimizerDemo();
+void LazyRelinDemo();
+void ConstantCacheDemo();
+void InnerProductDemo();
+void RotationKeyPlannerDemo();
+void DnumTunerDemo();
+void RotateManyDemo();
+void SlotSumDemo();
+void DigitSizeTunerDemo();
+void ScalingSweepDemo(const std::string& csvPath);
+void SlotPackerDemo();
+void BatchExecutorDemo();
+void DagSchedulerDemo();
+void KeyStoreDemo(const std::string& directory);
+void ContextRegistryDemo();
+
+Circuit TaskCircuit();
+Circuit NaiveManualCircuit();
+
+/*
+  usage: week4_task [--keystore dir] [--csv file] [demo...]
+
+  인자가 없으면 원래의 세 demo (FlexibleAuto, FixedAuto, FixedManual) 만 돌린다.
+  나머지는 이름으로 골라서 돌린다 (sweep / scaling 측정은 수 분이 걸린다).
+  "all" 은 전부, "list" 는 이름 목록.
+  KeyStore demo 는 --keystore 로 준 디렉터리 (없으면 임시 디렉터리) 에 key 를 저장한다.
+  ScalingSweep demo 는 --csv 로 준 파일 (없으면 임시 디렉터리의 scaling_sweep.csv) 에 결과를 쓴다.
+ */
 int main(int argc, char* argv[]) {
-   
-    AutomaticRescaleDemo(FLEXIBLEAUTO);
+    std::string keyStoreDir = (std::filesystem::temp_directory_path() / "week4-keystore-demo").string();
+    std::string csvPath     = (std::filesystem::temp_directory_path() / "scaling_sweep.csv").string();
+    std::vector<std::string> selected;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--keystore" && i + 1 < argc)
+            keyStoreDir = argv[++i];
+        else if (arg == "--csv" && i + 1 < argc)
+            csvPath = argv[++i];
+        else
+            selected.push_back(arg);
+    }
 
-    AutomaticRescaleDemo(FIXEDAUTO);
+    const std::vector<std::pair<std::string, std::function<void()>>> demos = {
+        {"FlexibleAuto", [] { AutomaticRescaleDemo(FLEXIBLEAUTO); }},
+        {"FixedAuto", [] { AutomaticRescaleDemo(FIXEDAUTO); }},
+        {"FixedManual", [] { ManualRescaleDemo(FIXEDMANUAL); }},
+        {"ParameterPlanner", ParameterPlannerDemo},
+        {"RescaleOptimizer", RescaleOptimizerDemo},
+        {"LazyRelin", LazyRelinDemo},
+        {"ConstantCache", ConstantCacheDemo},
+        {"InnerProduct", InnerProductDemo},
+        {"RotationKeyPlanner", RotationKeyPlannerDemo},
+        {"DnumTuner", DnumTunerDemo},
+        {"RotateMany", RotateManyDemo},
+        {"SlotSum", SlotSumDemo},
+        {"DigitSizeTuner", DigitSizeTunerDemo},
+        {"ScalingSweep", [&] { ScalingSweepDemo(csvPath); }},
+        {"SlotPacker", SlotPackerDemo},
+        {"BatchExecutor", BatchExecutorDemo},
+        {"DagScheduler", DagSchedulerDemo},
+        {"KeyStore", [&] { KeyStoreDemo(keyStoreDir); }},
+        {"ContextRegistry", ContextRegistryDemo},
+    };
+    const size_t numDefault = 3;
+
+    if (selected.empty()) {
+        for (size_t i = 0; i < numDefault; i++)
+            selected.push_back(demos[i].first);
+    }
+    else if (selected.size() == 1 && selected[0] == "all") {
+        selected.clear();
+        for (const auto& demo : demos)
+            selected.push_back(demo.first);
+    }
 
-    ManualRescaleDemo(FIXEDMANUAL);
+    // check every name before running anything
+    std::vector<std::function<void()>> run;
+    for (const auto& name : selected) {
+        auto demo = std::find_if(demos.begin(), demos.end(), [&](const auto& d) { return d.first == name; });
+        if (demo == demos.end()) {
+            if (name != "list")
+                std::cerr << "unknown demo " << name << std::endl;
+            std::cerr << "usage: " << argv[0] << " [--keystore dir] [--csv file] [all | demo...], demos:";
+            for (const auto& d : demos)
+                std::cerr << " " << d.first;
+            std::cerr << std::endl;
+            return name == "list" ? 0 : 1;
+        }
+        run.push_back(demo->second);
+    }
+
+    for (const auto& demo : run)
+        demo();
 
     return 0;
 }
@@ -61,11 +171,14 @@ void AutomaticRescaleDemo(ScalingTechnique scalTech) {
 
     //Computing f(x) = (x+1)^2*(x^2+2)
 
-    auto c1     = cc -> EvalAdd(c, 1.0);                    // (x+1)
-    auto c1_2   = cc -> EvalMult(c1, c1);                 //(x+1)^2
-    auto c2     = cc -> EvalMult(c, c);                   // x^2
-    auto c2_pl  = cc -> EvalAdd(c2, 2.0);                  // (x^2+2)
-    auto cRes   = cc -> EvalMult(c1_2, c2_pl);           // Final result
+    // 인수 (x+1), (x+1), (x^2+2) 를 넘기면 x^4 + 2x^3 + 3x^2 + 4x + 2 로 전개해서 계산
+    std::vector<std::vector<double>> factors = {{1, 1}, {1, 1}, {2, 0, 1}};
+
+    auto plan = PolyEvaluator::MakePlan(PolyEvaluator::ExpandFactors(factors));
+    std::cout << "PolyEvaluator: depth " << plan.depth << ", " << plan.nonScalarMults << " ciphertext mults, "
+              << plan.scalarMults << " scalar mults" << std::endl;
+
+    auto cRes = PolyEvaluator::EvalFactors(cc, c, factors);  // Final result
 
     Plaintext result;
     std::cout.precision(8);
@@ -107,7 +220,7 @@ void ManualRescaleDemo(ScalingTechnique scalTech) {
     parameters.SetScalingModSize(50);
     parameters.SetBatchSize(batchSize);
 
-    CryptoContext<DCRTPoly> cc = GenCryptoContext(parameters);
+    CryptoContext<DCRTPoly> cc = ContextRegistry::Get(parameters);
 
     std::cout << "CKKS scheme is using ring dimension " << cc->GetRingDimension() << std::endl << std::endl;
 
@@ -128,27 +241,24 @@ void ManualRescaleDemo(ScalingTechnique scalTech) {
 
 
     //Computing f(x) = (x+1)^2*(x^2+2)
+    // Rescale 은 곱셈 직전에만 한다 (RescaleOptimizer 가 만드는 배치와 같음).
+    // 덧셈 뒤에 rescale 하면 level 만 소모된다.
 
     // x+1
-    auto c_pl_depth2 = cc->EvalAdd(c, 1.0);
-    auto c_pl_depth1 = cc->Rescale(c_pl_depth2);
+    auto c_pl_depth1 = cc->EvalAdd(c, 1.0);
     // (x+1)^2
     auto c_pl_2_depth2 = cc->EvalMult(c_pl_depth1, c_pl_depth1);
-    auto c_pl_2_depth1 = cc->Rescale(c_pl_2_depth2);
     // x^2
     auto c2_depth2 = cc->EvalMult(c, c);
-    auto c2_depth1 = cc->Rescale(c2_depth2);
      // x^2+2
-    auto c2_pl_depth2 = cc->EvalAdd(c2_depth1, 2.0);
-    auto c2_pl_depth1 = cc->Rescale(c2_pl_depth2);
+    auto c2_pl_depth2 = cc->EvalAdd(c2_depth2, 2.0);
     // Final result
-    auto cRes_depth2 = cc->EvalMult(c_pl_2_depth1, c2_pl_depth1);
-    auto cRes_depth1 = cc->Rescale(cRes_depth2);
+    auto cRes_depth2 = cc->EvalMult(cc->Rescale(c_pl_2_depth2), cc->Rescale(c2_pl_depth2));
 
     Plaintext result;
     std::cout.precision(8);
 
-    cc->Decrypt(keys.secretKey, cRes_depth1, &result);
+    cc->Decrypt(keys.secretKey, cRes_depth2, &result);
     result->SetLength(batchSize);
     std::cout << "(x+1)^2 * (x^2+2) = " << result << std::endl;
 
@@ -160,7 +270,7 @@ void ManualRescaleDemo(ScalingTechnique scalTech) {
 
     TimeVar t;
     TIC(t);
-    auto cRot2         = cc->EvalRotate(cRes_depth1, 2);
+    auto cRot2         = cc->EvalRotate(cRes_depth2, 2);
     double time2digits = TOC(t);
 
     Plaintext rotate_result;
@@ -523,3 +633,899 @@ void FastRotationsDemo2() {
     std::cout << "Result with hoisting = " << result << std::endl;
     std::cout << " - 7 rotations on x with hoisting took " << timeHoisting << "ms" << std::endl;
 }
+
+// (x+1)^2*(x^2+2) 계산 후 왼쪽으로 2 rotation 하는 과제 circuit
+Circuit TaskCircuit() {
+    Circuit circuit;
+    auto x     = circuit.Input();
+    auto x1    = circuit.AddConst(x, 1.0);                  // (x+1)
+    auto x1_2  = circuit.Square(x1);                        // (x+1)^2
+    auto x2    = circuit.Square(x);                         // x^2
+    auto x2_pl = circuit.AddConst(x2, 2.0);                 // (x^2+2)
+    auto res   = circuit.Mult(x1_2, x2_pl);                 // (x+1)^2*(x^2+2)
+    circuit.Output(res);
+    circuit.Output(circuit.Rotate(res, 2));                 // rotate left 2
+    circuit.SetSlots(8);
+    return circuit;
+}
+
+void ParameterPlannerDemo() {
+
+    std::cout << "\n\n\n ===== ParameterPlannerDemo ============= " << std::endl;
+
+    Circuit circuit = TaskCircuit();
+
+    PlannerTarget target;
+    target.precisionBits = 20;
+    target.integerBits   = 10;
+    target.securityLevel = HEStd_128_classic;
+    target.scalTech      = FLEXIBLEAUTO;
+
+    std::cout << "Circuit depth " << circuit.GetDepth() << ", target precision " << target.precisionBits << " bits"
+              << std::endl;
+
+    // 모델로 비용을 계산한 후보들
+    std::cout << "Candidates (cheapest modeled first):" << std::endl;
+    for (const auto& candidate : ParameterPlanner::Candidates(circuit, target)) {
+        std::cout << "   " << candidate << std::endl;
+    }
+
+    // 상위 3개는 실제로 context 를 만들어 시간을 재고 가장 빠른 것을 고른다
+    ParameterPlan plan = ParameterPlanner::Plan(circuit, target, 3);
+    std::cout << "Chosen: " << plan << std::endl;
+
+    // N 은 OpenFHE 가 실제로 만든 modulus 를 보고 정한다
+    uint32_t modeledRingDim    = plan.ringDim;
+    CryptoContext<DCRTPoly> cc = ParameterPlanner::Build(circuit, plan);
+    std::cout << "Modeled N=" << modeledRingDim << ", built: " << plan << std::endl << std::endl;
+
+    std::cout << "CKKS scheme is using ring dimension " << cc->GetRingDimension() << std::endl << std::endl;
+
+    cc->Enable(PKE);
+    cc->Enable(KEYSWITCH);
+    cc->Enable(LEVELEDSHE);
+
+    auto keys = cc->KeyGen();
+    cc->EvalMultKeyGen(keys.secretKey);
+    cc->EvalRotateKeyGen(keys.secretKey, circuit.GetRotationIndices());
+
+    // Input
+    std::vector<double> x = {1.0, 1.01, 1.02, 1.03, 1.04, 1.05, 1.06, 1.07};
+    Plaintext ptxt        = cc->MakeCKKSPackedPlaintext(x);
+
+    std::cout << "Input x: " << ptxt << std::endl;
+
+    auto c       = cc->Encrypt(keys.publicKey, ptxt);
+    auto outputs = circuit.Evaluate(cc, {c});
+
+    Plaintext result;
+    std::cout.precision(8);
+
+    cc->Decrypt(keys.secretKey, outputs[0], &result);
+    result->SetLength(x.size());
+    std::cout << "(x+1)^2*(x^2+2) = " << result << std::endl;
+
+    cc->Decrypt(keys.secretKey, outputs[1], &result);
+    result->SetLength(x.size());
+    std::cout << "x left rotate by 2 = " << result << std::endl;
+}
+
+// ManualRescaleDemo 의 원래 코드처럼 연산마다 Rescale 하는 circuit
+Circuit NaiveManualCircuit() {
+    Circuit circuit;
+    auto x      = circuit.Input();
+    auto c_pl   = circuit.Rescale(circuit.AddConst(x, 1.0));     // x+1
+    auto c_pl_2 = circuit.Rescale(circuit.Square(c_pl));         // (x+1)^2
+    auto c2     = circuit.Rescale(circuit.Square(x));            // x^2
+    auto c2_pl  = circuit.Rescale(circuit.AddConst(c2, 2.0));    // x^2+2
+    auto res    = circuit.Rescale(circuit.Mult(c_pl_2, c2_pl));  // Final result
+    circuit.Output(res);
+    circuit.Output(circuit.Rotate(res, 2));
+    circuit.SetSlots(8);
+    return circuit;
+}
+
+void RescaleOptimizerDemo() {
+
+    std::cout << "\n\n\n ===== RescaleOptimizerDemo ============= " << std::endl;
+
+    Circuit naive     = NaiveManualCircuit();
+    Circuit optimized = RescaleOptimizer::Optimize(naive);
+
+    ManualCircuitStats naiveStats     = RescaleOptimizer::Analyze(naive);
+    ManualCircuitStats optimizedStats = RescaleOptimizer::Analyze(optimized);
+
+    std::cout << "Naive placement:     depth " << naiveStats.depth << ", " << naiveStats.rescales << " rescales"
+              << std::endl;
+    std::cout << "Optimized placement: depth " << optimizedStats.depth << ", " << optimizedStats.rescales
+              << " rescales" << std::endl;
+    std::cout << " - levels saved: " << naiveStats.depth - optimizedStats.depth << ", rescales saved: "
+              << naiveStats.rescales - optimizedStats.rescales << std::endl << std::endl;
+
+    std::vector<double> x = {1.0, 1.01, 1.02, 1.03, 1.04, 1.05, 1.06, 1.07};
+    const uint32_t numRuns = 10;
+
+    // 두 circuit 모두 naive depth 의 context 에서, 그리고 optimized 는 자신의 depth 로도 실행
+    std::vector<std::pair<const Circuit*, uint32_t>> runs = {
+        {&naive, naiveStats.depth}, {&optimized, naiveStats.depth}, {&optimized, optimizedStats.depth}};
+
+    for (const auto& run : runs) {
+        CCParams<CryptoContextCKKSRNS> parameters;
+        parameters.SetMultiplicativeDepth(run.second);
+        parameters.SetScalingModSize(50);
+        parameters.SetScalingTechnique(FIXEDMANUAL);
+        parameters.SetBatchSize(8);
+
+        CryptoContext<DCRTPoly> cc = GenCryptoContext(parameters);
+
+        cc->Enable(PKE);
+        cc->Enable(KEYSWITCH);
+        cc->Enable(LEVELEDSHE);
+
+        auto keys = cc->KeyGen();
+        cc->EvalMultKeyGen(keys.secretKey);
+        cc->EvalRotateKeyGen(keys.secretKey, {2});
+
+        auto c = cc->Encrypt(keys.publicKey, cc->MakeCKKSPackedPlaintext(x));
+
+        std::vector<Ciphertext<DCRTPoly>> outputs;
+        TimeVar t;
+        TIC(t);
+        for (uint32_t i = 0; i < numRuns; i++) {
+            outputs = run.first->Evaluate(cc, {c});
+        }
+        double timeRun = TOC(t) / numRuns;
+
+        Plaintext result;
+        std::cout.precision(8);
+        cc->Decrypt(keys.secretKey, outputs[0], &result);
+        result->SetLength(x.size());
+
+        std::cout << (run.first == &naive ? "Naive" : "Optimized") << " circuit, depth " << run.second << " (ring dimension "
+                  << cc->GetRingDimension() << "): " << timeRun << "ms" << std::endl;
+        std::cout << "   (x+1)^2*(x^2+2) = " << result << std::endl;
+    }
+}
+
+void LazyRelinDemo() {
+
+    std::cout << "\n\n\n ===== LazyRelinDemo ============= " << std::endl;
+
+    // 곱셈 결과들을 더한 뒤 곱하는 circuit: (x*y + x^2 + y^2 + 1) * (x + y)
+    Circuit sumOfProducts;
+    auto x   = sumOfProducts.Input();
+    auto y   = sumOfProducts.Input();
+    auto sum = sumOfProducts.Add(sumOfProducts.Add(sumOfProducts.Mult(x, y), sumOfProducts.Square(x)),
+                                 sumOfProducts.Square(y));
+    auto res = sumOfProducts.Mult(sumOfProducts.AddConst(sum, 1.0), sumOfProducts.Add(x, y));
+    sumOfProducts.Output(res);
+
+    std::vector<std::pair<std::string, Circuit>> circuits = {{"(x*y + x^2 + y^2 + 1) * (x + y)", sumOfProducts},
+                                                             {"(x+1)^2*(x^2+2), rotate 2", TaskCircuit()}};
+
+    uint32_t batchSize = 8;
+    CCParams<CryptoContextCKKSRNS> parameters;
+    parameters.SetMultiplicativeDepth(2);
+    parameters.SetScalingModSize(50);
+    parameters.SetBatchSize(batchSize);
+
+    CryptoContext<DCRTPoly> cc = GenCryptoContext(parameters);
+
+    std::cout << "CKKS scheme is using ring dimension " << cc->GetRingDimension() << std::endl << std::endl;
+
+    cc->Enable(PKE);
+    cc->Enable(KEYSWITCH);
+    cc->Enable(LEVELEDSHE);
+
+    auto keys = cc->KeyGen();
+    cc->EvalMultKeyGen(keys.secretKey);
+    cc->EvalRotateKeyGen(keys.secretKey, {2});
+
+    std::vector<double> x1 = {1.0, 1.01, 1.02, 1.03, 1.04, 1.05, 1.06, 1.07};
+    std::vector<double> x2 = {0.5, 0.51, 0.52, 0.53, 0.54, 0.55, 0.56, 0.57};
+    auto c1                = cc->Encrypt(keys.publicKey, cc->MakeCKKSPackedPlaintext(x1));
+    auto c2                = cc->Encrypt(keys.publicKey, cc->MakeCKKSPackedPlaintext(x2));
+
+    const uint32_t numRuns = 10;
+
+    for (const auto& entry : circuits) {
+        const Circuit& eager = entry.second;
+        Circuit lazy         = RelinScheduler::Lazy(eager);
+
+        std::vector<Ciphertext<DCRTPoly>> inputs = {c1, c2};
+        inputs.resize(eager.GetNumInputs());
+
+        const Circuit* versions[] = {&eager, &lazy};
+
+        std::cout << entry.first << std::endl;
+        for (const Circuit* circuit : versions) {
+            std::vector<Ciphertext<DCRTPoly>> outputs;
+            TimeVar t;
+            TIC(t);
+            for (uint32_t i = 0; i < numRuns; i++) {
+                outputs = circuit->Evaluate(cc, inputs);
+            }
+            double timeRun = TOC(t) / numRuns;
+
+            Plaintext result;
+            std::cout.precision(8);
+            cc->Decrypt(keys.secretKey, outputs[0], &result);
+            result->SetLength(batchSize);
+
+            CircuitCounts counts = circuit->GetCounts();
+            std::cout << (circuit == &eager ? " - eager: " : " - lazy:  ") << counts.relinearizations
+                      << " relinearizations, " << counts.KeySwitches() << " key switches, " << timeRun << "ms"
+                      << std::endl;
+            std::cout << "   result = " << result << std::endl;
+        }
+    }
+}
+
+void ConstantCacheDemo() {
+
+    std::cout << "\n\n\n ===== ConstantCacheDemo ============= " << std::endl;
+
+    uint32_t batchSize = 8;
+    CCParams<CryptoContextCKKSRNS> parameters;
+    parameters.SetMultiplicativeDepth(2);
+    parameters.SetScalingModSize(50);
+    parameters.SetBatchSize(batchSize);
+
+    CryptoContext<DCRTPoly> cc = ContextRegistry::Get(parameters);
+
+    std::cout << "CKKS scheme is using ring dimension " << cc->GetRingDimension() << std::endl << std::endl;
+
+    cc->Enable(PKE);
+    cc->Enable(KEYSWITCH);
+    cc->Enable(LEVELEDSHE);
+
+    auto keys = cc->KeyGen();
+    cc->EvalMultKeyGen(keys.secretKey);
+
+    std::vector<double> x = {1.0, 1.01, 1.02, 1.03, 1.04, 1.05, 1.06, 1.07};
+    auto c                = cc->Encrypt(keys.publicKey, cc->MakeCKKSPackedPlaintext(x));
+
+    // 슬롯마다 다른 상수: (x^2 + b) * w
+    std::vector<double> b = {2.0, 2.1, 2.2, 2.3, 2.4, 2.5, 2.6, 2.7};
+    std::vector<double> w = {0.5, 0.4, 0.3, 0.2, 0.1, 0.2, 0.3, 0.4};
+
+    auto c2 = cc->EvalMult(c, c);
+
+    const uint32_t numRequests = 100;
+    ConstantCache constants(cc);
+    Ciphertext<DCRTPoly> resEncode, resCached;
+
+    // every request encodes b and w again
+    TimeVar t;
+    TIC(t);
+    for (uint32_t i = 0; i < numRequests; i++) {
+        auto ptB  = cc->MakeCKKSPackedPlaintext(b, c2->GetNoiseScaleDeg(), c2->GetLevel());
+        auto sum  = cc->EvalAdd(c2, ptB);
+        auto ptW  = cc->MakeCKKSPackedPlaintext(w, 1, sum->GetLevel() + sum->GetNoiseScaleDeg() - 1);
+        resEncode = cc->EvalMult(sum, ptW);
+    }
+    double timeEncode = TOC_US(t) / numRequests;
+
+    TIC(t);
+    for (uint32_t i = 0; i < numRequests; i++) {
+        resCached = constants.EvalMult(constants.EvalAdd(c2, b), w);
+    }
+    double timeCached = TOC_US(t) / numRequests;
+
+    Plaintext result;
+    std::cout.precision(8);
+    cc->Decrypt(keys.secretKey, resEncode, &result);
+    result->SetLength(batchSize);
+    std::cout << "encode every request: " << timeEncode << " us/request, result = " << result << std::endl;
+    cc->Decrypt(keys.secretKey, resCached, &result);
+    result->SetLength(batchSize);
+    std::cout << "constant cache:       " << timeCached << " us/request, result = " << result << std::endl;
+    std::cout << " - " << constants.Size() << " cached plaintexts, " << constants.Hits() << " hits, "
+              << constants.Misses() << " misses" << std::endl;
+}
+
+void InnerProductDemo() {
+
+    std::cout << "\n\n\n ===== InnerProductDemo ============= " << std::endl;
+
+    uint32_t batchSize = 8;
+    CCParams<CryptoContextCKKSRNS> parameters;
+    parameters.SetMultiplicativeDepth(2);
+    parameters.SetScalingModSize(50);
+    parameters.SetBatchSize(batchSize);
+
+    CryptoContext<DCRTPoly> cc = ContextRegistry::Get(parameters);
+
+    std::cout << "CKKS scheme is using ring dimension " << cc->GetRingDimension() << std::endl << std::endl;
+
+    cc->Enable(PKE);
+    cc->Enable(KEYSWITCH);
+    cc->Enable(LEVELEDSHE);
+
+    auto keys = cc->KeyGen();
+    cc->EvalMultKeyGen(keys.secretKey);
+
+    // a[i] = (i+1)/16 * x, b[i] = x  ->  sum a[i]*b[i] = (1+2+...+16)/16 * x^2 = 8.5 x^2
+    const uint32_t numTerms = 16;
+    std::vector<double> x   = {1.0, 1.01, 1.02, 1.03, 1.04, 1.05, 1.06, 1.07};
+
+    std::vector<Ciphertext<DCRTPoly>> a, b;
+    for (uint32_t i = 0; i < numTerms; i++) {
+        std::vector<double> ai(x.size());
+        for (size_t j = 0; j < x.size(); j++)
+            ai[j] = (i + 1) * x[j] / numTerms;
+        a.push_back(cc->Encrypt(keys.publicKey, cc->MakeCKKSPackedPlaintext(ai)));
+        b.push_back(cc->Encrypt(keys.publicKey, cc->MakeCKKSPackedPlaintext(x)));
+    }
+
+    // EvalMult (relinearize every term) + EvalAdd
+    TimeVar t;
+    TIC(t);
+    auto cNaive = cc->EvalMult(a[0], b[0]);
+    for (uint32_t i = 1; i < numTerms; i++)
+        cNaive = cc->EvalAdd(cNaive, cc->EvalMult(a[i], b[i]));
+    double timeNaive = TOC(t);
+
+    TIC(t);
+    auto cFused      = EvalInnerProduct(cc, a, b);
+    double timeFused = TOC(t);
+
+    Plaintext result;
+    std::cout.precision(8);
+    cc->Decrypt(keys.secretKey, cNaive, &result);
+    result->SetLength(batchSize);
+    std::cout << numTerms << "-term inner product" << std::endl;
+    std::cout << " - EvalMult + EvalAdd:  " << numTerms << " key switches, " << timeNaive << "ms" << std::endl;
+    std::cout << "   result = " << result << std::endl;
+    cc->Decrypt(keys.secretKey, cFused, &result);
+    result->SetLength(batchSize);
+    std::cout << " - EvalInnerProduct:    1 key switch, " << timeFused << "ms" << std::endl;
+    std::cout << "   result = " << result << std::endl;
+}
+
+void RotationKeyPlannerDemo() {
+
+    std::cout << "\n\n\n ===== RotationKeyPlannerDemo ============= " << std::endl;
+
+    uint32_t batchSize = 8;
+    CCParams<CryptoContextCKKSRNS> parameters;
+    parameters.SetMultiplicativeDepth(1);
+    parameters.SetScalingModSize(50);
+    parameters.SetBatchSize(batchSize);
+
+    CryptoContext<DCRTPoly> cc = GenCryptoContext(parameters);
+
+    std::cout << "CKKS scheme is using ring dimension " << cc->GetRingDimension() << std::endl << std::endl;
+
+    cc->Enable(PKE);
+    cc->Enable(KEYSWITCH);
+    cc->Enable(LEVELEDSHE);
+
+    auto keys = cc->KeyGen();
+
+    std::vector<double> x = {0, 0, 0, 0, 0, 0, 0, 1};
+    auto c                = cc->Encrypt(keys.publicKey, cc->MakeCKKSPackedPlaintext(x));
+
+    // FastRotationsDemo1 과 같은 rotation 들: x + rot(x, 1) + ... + rot(x, 7)
+    std::vector<int32_t> needed = {1, 2, 3, 4, 5, 6, 7};
+    double keyBytes             = RotationKeyPlanner::KeyBytes(cc);
+    double budget               = 4 * keyBytes;
+
+    std::cout << "One rotation key: " << keyBytes / (1 << 20) << "MB (modeled), budget: " << budget / (1 << 20)
+              << "MB" << std::endl;
+
+    auto candidates = RotationKeyPlanner::Candidates(needed, batchSize, keyBytes);
+    for (auto& set : candidates) {
+        cc->ClearEvalAutomorphismKeys();
+
+        TimeVar t;
+        TIC(t);
+        cc->EvalRotateKeyGen(keys.secretKey, set.keys);
+        double timeKeyGen = TOC(t);
+
+        TIC(t);
+        auto rotated   = RotationKeyPlanner::EvalRotations(cc, c, set, needed);
+        set.measuredMs = TOC(t);
+
+        auto cRes = c;
+        for (int32_t r : needed)
+            cRes = cRes + rotated[r];
+
+        Plaintext result;
+        std::cout.precision(8);
+        cc->Decrypt(keys.secretKey, cRes, &result);
+        result->SetLength(batchSize);
+        std::cout << set << " keygen=" << timeKeyGen << "ms" << std::endl;
+        std::cout << "   result = " << result << std::endl;
+    }
+
+    RotationKeySet plan = RotationKeyPlanner::Plan(needed, batchSize, keyBytes, budget);
+    std::cout << "Chosen for the budget: " << plan << std::endl;
+}
+
+void DnumTunerDemo() {
+
+    std::cout << "\n\n\n ===== DnumTunerDemo ============= " << std::endl;
+
+    // HybridKeySwitchingDemo1/2 와 같은 파라미터, dnum 만 자동으로
+    uint32_t batchSize = 8;
+    CCParams<CryptoContextCKKSRNS> parameters;
+    parameters.SetMultiplicativeDepth(5);
+    parameters.SetScalingModSize(50);
+    parameters.SetBatchSize(batchSize);
+    parameters.SetScalingTechnique(FLEXIBLEAUTO);
+
+    TimeVar t;
+    TIC(t);
+    auto measurements = DnumTuner::Measure(parameters);
+    double timeTune   = TOC(t);
+
+    for (const auto& m : measurements)
+        std::cout << m << std::endl;
+    std::cout << " - measuring " << measurements.size() << " contexts took " << timeTune << "ms" << std::endl;
+
+    // latency only (rotation + relinearization)
+    DnumMeasurement fastest = DnumTuner::Tune(parameters);
+    std::cout << "Lowest latency:        " << fastest << std::endl;
+
+    // 1 MB of key memory weighs as much as 1 ms
+    DnumObjective objective;
+    objective.memoryWeight = 1.0;
+    TIC(t);
+    DnumMeasurement balanced = DnumTuner::Tune(parameters, objective);
+    double timeCached        = TOC(t);
+    std::cout << "Latency + key memory:  " << balanced << std::endl;
+    std::cout << " - tuning again from the cache took " << timeCached << "ms" << std::endl;
+
+    CryptoContext<DCRTPoly> cc = GenCryptoContext(parameters);
+    std::cout << "CKKS scheme is using ring dimension " << cc->GetRingDimension() << " with dnum "
+              << balanced.dnum << std::endl;
+}
+
+void RotateManyDemo() {
+
+    std::cout << "\n\n\n ===== RotateManyDemo ============= " << std::endl;
+
+    uint32_t batchSize = 64;
+    CCParams<CryptoContextCKKSRNS> parameters;
+    parameters.SetMultiplicativeDepth(1);
+    parameters.SetScalingModSize(50);
+    parameters.SetBatchSize(batchSize);
+
+    CryptoContext<DCRTPoly> cc = GenCryptoContext(parameters);
+
+    std::cout << "CKKS scheme is using ring dimension " << cc->GetRingDimension() << std::endl << std::endl;
+
+    cc->Enable(PKE);
+    cc->Enable(KEYSWITCH);
+    cc->Enable(LEVELEDSHE);
+
+    auto keys = cc->KeyGen();
+
+    std::vector<int32_t> allIndices;
+    for (int32_t i = 1; i <= 64; i++)
+        allIndices.push_back(i);
+    cc->EvalRotateKeyGen(keys.secretKey, allIndices);
+
+    std::vector<double> x(batchSize, 0.0);
+    x[batchSize - 1] = 1;
+    auto c           = cc->Encrypt(keys.publicKey, cc->MakeCKKSPackedPlaintext(x));
+
+    for (size_t numRotations : {16, 32, 64}) {
+        std::vector<int32_t> indices(allIndices.begin(), allIndices.begin() + numRotations);
+
+        TimeVar t;
+        TIC(t);
+        std::vector<Ciphertext<DCRTPoly>> plain;
+        for (int32_t index : indices)
+            plain.push_back(cc->EvalRotate(c, index));
+        double timePlain = TOC(t);
+
+        // FastRotationsDemo1 처럼 직접 hoisting (스레드 1개)
+        TIC(t);
+        uint32_t M    = cc->GetCyclotomicOrder();
+        auto cPrecomp = cc->EvalFastRotationPrecompute(c);
+        std::vector<Ciphertext<DCRTPoly>> hoisted;
+        for (int32_t index : indices)
+            hoisted.push_back(cc->EvalFastRotation(c, index, M, cPrecomp));
+        double timeHoisted = TOC(t);
+
+        TIC(t);
+        auto many       = EvalRotateMany(cc, c, indices);
+        double timeMany = TOC(t);
+
+        auto cRes = many[0];
+        for (size_t i = 1; i < many.size(); i++)
+            cRes = cRes + many[i];
+
+        Plaintext result;
+        std::cout.precision(8);
+        cc->Decrypt(keys.secretKey, cRes, &result);
+        result->SetLength(batchSize);
+
+        std::cout << numRotations << " rotations: EvalRotate " << timePlain << "ms, hoisted " << timeHoisted
+                  << "ms, EvalRotateMany " << timeMany << "ms" << std::endl;
+        std::cout << "   sum of rotations = " << result << std::endl;
+    }
+}
+
+void SlotSumDemo() {
+
+    std::cout << "\n\n\n ===== SlotSumDemo ============= " << std::endl;
+
+    uint32_t batchSize = 1024;
+    CCParams<CryptoContextCKKSRNS> parameters;
+    parameters.SetMultiplicativeDepth(1);
+    parameters.SetScalingModSize(50);
+    parameters.SetBatchSize(batchSize);
+
+    CryptoContext<DCRTPoly> cc = GenCryptoContext(parameters);
+
+    std::cout << "CKKS scheme is using ring dimension " << cc->GetRingDimension() << std::endl << std::endl;
+
+    cc->Enable(PKE);
+    cc->Enable(KEYSWITCH);
+    cc->Enable(LEVELEDSHE);
+
+    auto keys = cc->KeyGen();
+
+    // (window, stride): 창 크기 8, 64, 100, 1024 (전체 합), 그리고 stride 32 로 열 합
+    std::vector<std::pair<uint32_t, uint32_t>> windows = {{8, 1}, {64, 1}, {100, 1}, {1024, 1}, {32, 32}};
+
+    std::set<int32_t> indices;
+    for (const auto& w : windows)
+        for (int32_t index : SlotSum::RotationIndices(w.first, w.second))
+            indices.insert(index);
+    // linear summation of the 8- and 64-slot windows, for comparison
+    for (int32_t i = 1; i < 64; i++)
+        indices.insert(i);
+    cc->EvalRotateKeyGen(keys.secretKey, std::vector<int32_t>(indices.begin(), indices.end()));
+
+    std::vector<double> x(batchSize);
+    for (uint32_t i = 0; i < batchSize; i++)
+        x[i] = static_cast<double>(i % 16) / 16;
+    auto c = cc->Encrypt(keys.publicKey, cc->MakeCKKSPackedPlaintext(x));
+
+    for (const auto& w : windows) {
+        uint32_t n      = w.first;
+        uint32_t stride = w.second;
+
+        double expected = 0;
+        for (uint32_t j = 0; j < n; j++)
+            expected += x[(j * stride) % batchSize];
+
+        TimeVar t;
+        TIC(t);
+        auto cSum      = SlotSum::EvalWindowSum(cc, c, n, stride);
+        double timeSum = TOC(t);
+
+        Plaintext result;
+        std::cout.precision(8);
+        cc->Decrypt(keys.secretKey, cSum, &result);
+        result->SetLength(4);
+
+        std::cout << "window " << n << ", stride " << stride << ": " << SlotSum::RotationIndices(n, stride).size()
+                  << " rotation keys, " << timeSum << "ms";
+
+        if (stride == 1 && n <= 64) {
+            // c + Rotate(c, 1) + ... + Rotate(c, n-1), as in FastRotationsDemo1
+            TIC(t);
+            auto cLin = c;
+            for (int32_t i = 1; i < static_cast<int32_t>(n); i++)
+                cLin = cc->EvalAdd(cLin, cc->EvalRotate(c, i));
+            std::cout << " (linear: " << n - 1 << " rotations, " << TOC(t) << "ms)";
+        }
+        std::cout << std::endl;
+        std::cout << "   expected slot 0 = " << expected << ", result = " << result << std::endl;
+    }
+}
+
+void DigitSizeTunerDemo() {
+
+    std::cout << "\n\n\n ===== DigitSizeTunerDemo ============= " << std::endl;
+
+    // FastRotationsDemo2 의 BV digitSize = 10 을 회로 기준으로 고르기
+    Circuit circuit = TaskCircuit();
+
+    CCParams<CryptoContextCKKSRNS> parameters;
+    parameters.SetMultiplicativeDepth(circuit.GetDepth());
+    parameters.SetScalingModSize(50);
+    parameters.SetBatchSize(circuit.GetSlots());
+
+    auto points = DigitSizeTuner::Sweep(circuit, parameters);
+    for (const auto& p : points)
+        std::cout << p << std::endl;
+    std::cout << "(* = Pareto frontier of circuit time vs precision)" << std::endl;
+
+    const double minPrecisionBits = 25;
+    KeySwitchPoint chosen         = DigitSizeTuner::Tune(circuit, parameters, minPrecisionBits);
+    std::cout << "Fastest with at least " << minPrecisionBits << " bits: " << chosen << std::endl;
+
+    CryptoContext<DCRTPoly> cc = GenCryptoContext(parameters);
+    std::cout << "CKKS scheme is using ring dimension " << cc->GetRingDimension() << std::endl;
+}
+
+void ScalingSweepDemo(const std::string& csvPath) {
+
+    std::cout << "\n\n\n ===== ScalingSweepDemo ============= " << std::endl;
+
+    // AutomaticRescaleDemo / ManualRescaleDemo 의 회로를 scaling technique, scaling mod size 별로 측정
+    Circuit circuit = TaskCircuit();
+
+    CCParams<CryptoContextCKKSRNS> parameters;
+    parameters.SetBatchSize(circuit.GetSlots());
+
+    auto points = ScalingSweep::Sweep(circuit, parameters);
+    for (const auto& p : points)
+        std::cout << p << std::endl;
+    std::cout << "(* = Pareto frontier of latency, memory and precision)" << std::endl;
+
+    std::ofstream csv(csvPath);
+    ScalingSweep::WriteCsv(csv, points);
+    if (csv.flush())
+        std::cout << "Written to " << csvPath << std::endl;
+    else
+        std::cerr << "cannot write " << csvPath << std::endl;
+
+    const double minPrecisionBits = 20;
+    const ScalingPoint* chosen    = ScalingSweep::Cheapest(points, minPrecisionBits);
+    if (chosen)
+        std::cout << "Fastest with at least " << minPrecisionBits << " bits: " << *chosen << std::endl;
+    else
+        std::cout << "No configuration reaches " << minPrecisionBits << " bits" << std::endl;
+}
+
+void SlotPackerDemo() {
+
+    std::cout << "\n\n\n ===== SlotPackerDemo ============= " << std::endl;
+
+    // TaskCircuit 의 (x+1)^2*(x^2+2) 부분만 (rotation 은 chunk 안에서만 돌기 때문에 제외)
+    Circuit circuit;
+    auto x  = circuit.Input();
+    auto x1 = circuit.Square(circuit.AddConst(x, 1.0));
+    auto x2 = circuit.AddConst(circuit.Square(x), 2.0);
+    circuit.Output(circuit.Mult(x1, x2));
+
+    const size_t numValues = 1 << 16;
+    std::vector<double> stream(numValues);
+    for (size_t i = 0; i < numValues; i++)
+        stream[i] = static_cast<double>(i % 1000) / 1000;
+
+    // batch size 8 (지금까지의 demo) vs 전체 slot
+    for (uint32_t batchSize : {8u, 0u}) {
+        CCParams<CryptoContextCKKSRNS> parameters;
+        parameters.SetMultiplicativeDepth(circuit.GetDepth());
+        parameters.SetScalingModSize(50);
+        if (batchSize > 0)
+            parameters.SetBatchSize(batchSize);
+
+        CryptoContext<DCRTPoly> cc = GenCryptoContext(parameters);
+        cc->Enable(PKE);
+        cc->Enable(KEYSWITCH);
+        cc->Enable(LEVELEDSHE);
+
+        auto keys = cc->KeyGen();
+        cc->EvalMultKeyGen(keys.secretKey);
+
+        SlotPacker packer(cc, keys.publicKey, keys.secretKey);
+
+        // 8 slot 씩으로는 전체 스트림이 너무 오래 걸려서 앞부분만
+        size_t n = batchSize > 0 ? 1024 : numValues;
+        std::vector<std::vector<double>> streams = {std::vector<double>(stream.begin(), stream.begin() + n)};
+
+        PackingReport report;
+        auto outputs  = packer.Evaluate(circuit, streams, &report);
+        auto expected = circuit.EvaluatePlain(streams);
+
+        double maxError = 0;
+        for (size_t i = 0; i < n; i++)
+            maxError = std::max(maxError, std::abs(outputs[0][i] - expected[0][i]));
+
+        std::cout << report << ", max error " << maxError << std::endl;
+    }
+}
+
+void BatchExecutorDemo() {
+
+    std::cout << "\n\n\n ===== BatchExecutorDemo ============= " << std::endl;
+
+    Circuit circuit;
+    auto x  = circuit.Input();
+    auto x1 = circuit.Square(circuit.AddConst(x, 1.0));
+    auto x2 = circuit.AddConst(circuit.Square(x), 2.0);
+    circuit.Output(circuit.Mult(x1, x2));
+
+    CCParams<CryptoContextCKKSRNS> parameters;
+    parameters.SetMultiplicativeDepth(circuit.GetDepth());
+    parameters.SetScalingModSize(50);
+
+    CryptoContext<DCRTPoly> cc = GenCryptoContext(parameters);
+    cc->Enable(PKE);
+    cc->Enable(KEYSWITCH);
+    cc->Enable(LEVELEDSHE);
+
+    auto keys = cc->KeyGen();
+    cc->EvalMultKeyGen(keys.secretKey);
+
+    // 32 개의 꽉 찬 암호문
+    SlotPacker packer(cc, keys.publicKey, keys.secretKey);
+    std::vector<double> stream(32 * packer.GetSlots());
+    for (size_t i = 0; i < stream.size(); i++)
+        stream[i] = static_cast<double>(i % 1000) / 1000;
+
+    std::vector<std::vector<Ciphertext<DCRTPoly>>> batch;
+    for (const auto& ct : packer.Encrypt(stream))
+        batch.push_back({ct});
+    std::cout << batch.size() << " ciphertexts of " << packer.GetSlots() << " slots, "
+              << std::thread::hardware_concurrency() << " cores" << std::endl;
+
+    for (const auto& p : BatchExecutor::ScalingReport(cc, circuit, batch))
+        std::cout << p << std::endl;
+
+    // 결과 확인
+    WorkStealingPool pool;
+    auto outputs = BatchExecutor::Run(cc, circuit, batch, pool);
+    std::vector<Ciphertext<DCRTPoly>> first;
+    for (const auto& output : outputs)
+        first.push_back(output[0]);
+    std::vector<double> result   = packer.Unpack(first, stream.size());
+    std::vector<double> expected = circuit.EvaluatePlain({stream})[0];
+
+    double maxError = 0;
+    for (size_t i = 0; i < stream.size(); i++)
+        maxError = std::max(maxError, std::abs(result[i] - expected[i]));
+    std::cout << "max error " << maxError << std::endl;
+}
+
+void DagSchedulerDemo() {
+
+    std::cout << "\n\n\n ===== DagSchedulerDemo ============= " << std::endl;
+
+    // 서로 독립인 부분이 많은 회로: 15차 다항식 + (x+1)^2 * (x^2+2) + y 쪽 가지
+    Circuit circuit;
+    auto x = circuit.Input();
+    auto y = circuit.Input();
+    std::vector<double> coeffs(16);
+    for (size_t i = 0; i < coeffs.size(); i++)
+        coeffs[i] = 1.0 / (i + 1);
+    circuit.Output(circuit.Polynomial(x, coeffs));
+    auto x1 = circuit.Square(circuit.AddConst(x, 1.0));
+    auto x2 = circuit.AddConst(circuit.Square(x), 2.0);
+    circuit.Output(circuit.Mult(x1, x2));
+    circuit.Output(circuit.Mult(circuit.Square(y), circuit.MultConst(y, 0.5)));
+
+    CCParams<CryptoContextCKKSRNS> parameters;
+    parameters.SetMultiplicativeDepth(circuit.GetDepth());
+    parameters.SetScalingModSize(50);
+    parameters.SetBatchSize(8);
+
+    CryptoContext<DCRTPoly> cc = GenCryptoContext(parameters);
+    cc->Enable(PKE);
+    cc->Enable(KEYSWITCH);
+    cc->Enable(LEVELEDSHE);
+
+    auto keys = cc->KeyGen();
+    cc->EvalMultKeyGen(keys.secretKey);
+
+    std::vector<double> xs = {0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8};
+    std::vector<double> ys = {0.8, 0.7, 0.6, 0.5, 0.4, 0.3, 0.2, 0.1};
+    std::vector<Ciphertext<DCRTPoly>> inputs = {cc->Encrypt(keys.publicKey, cc->MakeCKKSPackedPlaintext(xs)),
+                                                cc->Encrypt(keys.publicKey, cc->MakeCKKSPackedPlaintext(ys))};
+    std::vector<std::vector<double>> expected = circuit.EvaluatePlain({xs, ys});
+
+    auto maxError = [&](const std::vector<Ciphertext<DCRTPoly>>& outputs) {
+        double error = 0;
+        for (size_t j = 0; j < outputs.size(); j++) {
+            Plaintext result;
+            cc->Decrypt(keys.secretKey, outputs[j], &result);
+            result->SetLength(xs.size());
+            std::vector<double> values = result->GetRealPackedValue();
+            for (size_t i = 0; i < xs.size(); i++)
+                error = std::max(error, std::abs(values[i] - expected[j][i]));
+        }
+        return error;
+    };
+
+    TimeVar t;
+    TIC(t);
+    auto sequential = circuit.Evaluate(cc, inputs);
+    double sequentialMs = TOC(t);
+    std::cout << circuit.GetNodes().size() << " nodes, depth " << circuit.GetDepth() << std::endl;
+    std::cout << "Circuit::Evaluate: " << sequentialMs << "ms, max error " << maxError(sequential) << std::endl;
+
+    WorkStealingPool pool(4);
+    for (uint32_t maxLive : {0u, 8u, 4u}) {
+        DagScheduler scheduler(pool, maxLive);
+        DagScheduleStats stats;
+        auto outputs = scheduler.Evaluate(cc, circuit, inputs, &stats);
+        std::cout << "DagScheduler, " << pool.GetNumThreads() << " workers, maxLive "
+                  << (maxLive ? std::to_string(maxLive) : "-") << ": " << stats << ", max error "
+                  << maxError(outputs) << std::endl;
+    }
+}
+
+void KeyStoreDemo(const std::string& directory) {
+
+    std::cout << "\n\n\n ===== KeyStoreDemo ============= " << std::endl;
+
+    // rotation 1, 2 만 쓰는 회로; key 는 1..16 을 모두 만들어 저장해 둔다
+    Circuit circuit;
+    auto x = circuit.Input();
+    circuit.Output(circuit.Add(circuit.Rotate(circuit.Square(x), 1), circuit.Rotate(x, 2)));
+
+    std::vector<int32_t> rotations;
+    for (int32_t i = 1; i <= 16; i++)
+        rotations.push_back(i);
+
+    CCParams<CryptoContextCKKSRNS> parameters;
+    parameters.SetMultiplicativeDepth(circuit.GetDepth());
+    parameters.SetScalingModSize(50);
+    parameters.SetBatchSize(8);
+
+    // 같은 파라미터로 저장된 것이 있으면 읽기만 한다 (파라미터가 바뀌었으면 다시 만든다)
+    TimeVar t;
+    if (!KeyStore(directory).Exists(parameters)) {
+        TIC(t);
+        CryptoContext<DCRTPoly> cc = GenCryptoContext(parameters);
+        cc->Enable(PKE);
+        cc->Enable(KEYSWITCH);
+        cc->Enable(LEVELEDSHE);
+
+        auto keys = cc->KeyGen();
+        cc->EvalMultKeyGen(keys.secretKey);
+        cc->EvalRotateKeyGen(keys.secretKey, rotations);
+        std::cout << "generated context and " << rotations.size() + 1 << " evaluation keys in " << TOC(t) << "ms"
+                  << std::endl;
+
+        TIC(t);
+        KeyStore(directory).Save(parameters, cc, keys);
+        std::cout << "saved to " << directory << " (secret key included) in " << TOC(t) << "ms" << std::endl;
+
+        // 새 프로세스처럼: 이 key tag 의 evaluation key 만 버린다 (다른 demo 의 context / key 는 그대로)
+        cc->ClearEvalMultKeys(keys.secretKey->GetKeyTag());
+        cc->ClearEvalAutomorphismKeys(keys.secretKey->GetKeyTag());
+    }
+
+    TIC(t);
+    KeyStore store(directory);
+    CryptoContext<DCRTPoly> cc = store.Load();
+    store.LoadRotations(circuit);
+    std::cout << "loaded in " << TOC(t) << "ms: " << store.GetStats() << std::endl;
+
+    const auto& keys         = store.GetKeys();
+    std::vector<double> xs   = {0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8};
+    auto outputs             = circuit.Evaluate(cc, {cc->Encrypt(keys.publicKey, cc->MakeCKKSPackedPlaintext(xs))});
+    std::vector<double> want = circuit.EvaluatePlain({xs})[0];
+
+    Plaintext result;
+    cc->Decrypt(keys.secretKey, outputs[0], &result);
+    result->SetLength(xs.size());
+    double maxError = 0;
+    for (size_t i = 0; i < xs.size(); i++)
+        maxError = std::max(maxError, std::abs(result->GetRealPackedValue()[i] - want[i]));
+    std::cout << "max error " << maxError << std::endl;
+}
+
+void ContextRegistryDemo() {
+
+    std::cout << "\n\n\n ===== ContextRegistryDemo ============= " << std::endl;
+
+    // ManualRescaleDemo, ConstantCacheDemo, InnerProductDemo 와 같은 파라미터
+    CCParams<CryptoContextCKKSRNS> parameters;
+    parameters.SetMultiplicativeDepth(2);
+    parameters.SetScalingModSize(50);
+    parameters.SetBatchSize(8);
+
+    std::cout << ContextRegistry::Size() << " parameter sets registered, key hash "
+              << std::hash<std::string>{}(ContextRegistry::CanonicalKey(parameters)) << std::endl;
+
+    for (uint32_t requests : {1u, 4u, 16u})
+        std::cout << ContextRegistry::Measure(parameters, requests) << std::endl;
+
+    // 파라미터가 하나라도 다르면 다른 context
+    CCParams<CryptoContextCKKSRNS> deeper = parameters;
+    deeper.SetMultiplicativeDepth(3);
+    std::cout << "depth 2 and depth 3 share a context: " << std::boolalpha
+              << (ContextRegistry::Get(parameters) == ContextRegistry::Get(deeper)) << std::noboolalpha
+              << ", " << ContextRegistry::Size() << " parameter sets registered" << std::endl;
+}
@@ -0,0 +1,215 @@
+/*
+  Work-stealing thread pool for running independent homomorphic operations
+
+  암호문 단위 (또는 회로 node 단위) 작업을 여러 스레드에 나눠 돌리는 pool. 스레드마다 자기
+  deque 가 있고, 비면 다른 스레드의 deque 에서 작업을 훔쳐 온다. OpenFHE 내부의 OpenMP
+  스레드 수도 같이 맞춰서 코어 수를 넘지 않게 한다.
+ */
+
+#ifndef CAU_PRE_WORK_STEALING_POOL_H
+#define CAU_PRE_WORK_STEALING_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef _OPENMP
+    #include <omp.h>
+#endif
+
+namespace lbcrypto {
+
+/**
+ * @brief WorkStealingPool
+ *
+ * Every worker owns a deque. Submit() from a worker pushes to the back of
+ * its own deque (so tasks a task spawns stay on the same core, hot in
+ * cache); Submit() from any other thread deals tasks round-robin. A worker
+ * pops from the back of its own deque and, when that is empty, steals from
+ * the front of the others, i.e. the oldest and usually largest pending
+ * work.
+ *
+ * OpenFHE parallelizes inside single operations with OpenMP (over RNS
+ * limbs, key switching digits, ...). Running W workers that each start a
+ * full OpenMP team would put W times the cores to work, so each worker sets
+ * its own OpenMP thread count (omp_set_num_threads is per thread) to
+ * ompThreadsPerWorker, by default cores / W and at least 1. With one worker
+ * the operations keep all cores; with one worker per core they run
+ * single-threaded and the parallelism is across tasks.
+ *
+ * Wait() returns when every submitted task, including tasks submitted by
+ * tasks, has finished, and rethrows the first exception one of them threw.
+ */
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(uint32_t numThreads = 0, uint32_t ompThreadsPerWorker = 0) {
+        uint32_t cores = std::max(1u, std::thread::hardware_concurrency());
+        if (numThreads == 0)
+            numThreads = cores;
+        if (ompThreadsPerWorker == 0)
+            ompThreadsPerWorker = std::max(1u, cores / numThreads);
+        m_ompThreads = ompThreadsPerWorker;
+
+        for (uint32_t i = 0; i < numThreads; i++)
+            m_queues.push_back(std::make_unique<Queue>());
+        for (uint32_t i = 0; i < numThreads; i++)
+            m_threads.emplace_back([this, i] { WorkerLoop(i); });
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_workReady.notify_all();
+        for (auto& thread : m_threads)
+            thread.join();
+    }
+
+    WorkStealingPool(const WorkStealingPool&)            = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void Submit(std::function<void()> task) {
+        size_t queue =
+            CurrentWorker() >= 0 ? static_cast<size_t>(CurrentWorker()) : m_nextQueue++ % m_queues.size();
+        // counted first, so that Wait() cannot return before the task has run
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pending++;
+            m_queued++;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_queues[queue]->mutex);
+            m_queues[queue]->tasks.push_back(std::move(task));
+        }
+        m_workReady.notify_one();
+    }
+
+    void Wait() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_allDone.wait(lock, [this] { return m_pending == 0; });
+        if (m_error) {
+            std::exception_ptr error = m_error;
+            m_error                  = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+    uint32_t GetNumThreads() const {
+        return static_cast<uint32_t>(m_threads.size());
+    }
+
+    uint32_t GetOmpThreadsPerWorker() const {
+        return m_ompThreads;
+    }
+
+    // tasks a worker took from another worker's deque
+    uint64_t GetSteals() const {
+        return m_steals;
+    }
+
+    /**
+   * Index of the pool worker running the calling thread, -1 outside
+   * the pool
+   */
+    int CurrentWorker() const {
+        return t_pool == this ? t_worker : -1;
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool TryPop(size_t worker, std::function<void()>& task) {
+        {
+            Queue& own = *m_queues[worker];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+        for (size_t k = 1; k < m_queues.size(); k++) {
+            Queue& victim = *m_queues[(worker + k) % m_queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                m_steals++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void WorkerLoop(size_t worker) {
+        t_pool   = this;
+        t_worker = static_cast<int>(worker);
+#ifdef _OPENMP
+        omp_set_num_threads(static_cast<int>(m_ompThreads));
+#endif
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_workReady.wait(lock, [this] { return m_stop || m_queued > 0; });
+                if (m_stop)
+                    return;
+            }
+
+            std::function<void()> task;
+            if (!TryPop(worker, task))
+                continue;  // another worker got it first
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_queued--;
+            }
+
+            try {
+                task();
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_error)
+                    m_error = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_pending == 0)
+                m_allDone.notify_all();
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_threads;
+    uint32_t m_ompThreads = 1;
+
+    std::mutex m_mutex;
+    std::condition_variable m_workReady;
+    std::condition_variable m_allDone;
+    size_t m_pending = 0;  // submitted and not finished
+    size_t m_queued  = 0;  // submitted and not started
+    bool m_stop      = false;
+    std::exception_ptr m_error;
+
+    std::atomic<size_t> m_nextQueue{0};
+    std::atomic<uint64_t> m_steals{0};
+
+    static inline thread_local const WorkStealingPool* t_pool = nullptr;
+    static inline thread_local int t_worker                   = -1;
+};
+
+}  // namespace lbcrypto
+
+#endif
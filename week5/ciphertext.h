@@ -42,6 +42,7 @@
 #include "metadata.h"
 #include "key/key.h"
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <utility>
@@ -49,6 +50,10 @@
 #include <map>
 
 namespace lbcrypto {
+
+template <class Element>
+class CiphertextPool;
+
 /**
  * @brief CiphertextImpl
  *
@@ -85,56 +90,49 @@ public:
     /**
    * Copy constructor
    */
-    CiphertextImpl(const CiphertextImpl<Element>& ciphertext) : CryptoObject<Element>(ciphertext) {
-        m_elements         = ciphertext.m_elements;
-        m_noiseScaleDeg    = ciphertext.m_noiseScaleDeg;
-        m_level            = ciphertext.m_level;
-        m_hopslevel        = ciphertext.m_hopslevel;
-        m_scalingFactor    = ciphertext.m_scalingFactor;
-        m_scalingFactorInt = ciphertext.m_scalingFactorInt;
-        encodingType       = ciphertext.encodingType;
-        m_slots            = ciphertext.m_slots;
-        m_metadataMap      = ciphertext.m_metadataMap;
-    }
+    CiphertextImpl(const CiphertextImpl<Element>& ciphertext)
+        : CryptoObject<Element>(ciphertext),
+          m_elements(ciphertext.m_elements),
+          m_noiseScaleDeg(ciphertext.m_noiseScaleDeg),
+          encodingType(ciphertext.encodingType),
+          m_scalingFactor(ciphertext.m_scalingFactor),
+          m_scalingFactorInt(ciphertext.m_scalingFactorInt),
+          m_level(ciphertext.m_level),
+          m_hopslevel(ciphertext.m_hopslevel),
+          m_slots(ciphertext.m_slots),
+          m_metadataMap(ciphertext.m_metadataMap) {}
 
-    explicit CiphertextImpl(Ciphertext<Element> ciphertext) : CryptoObject<Element>(*ciphertext) {
-        m_elements         = ciphertext->m_elements;
-        m_noiseScaleDeg    = ciphertext->m_noiseScaleDeg;
-        m_level            = ciphertext->m_level;
-        m_hopslevel        = ciphertext->m_hopslevel;
-        m_scalingFactor    = ciphertext->m_scalingFactor;
-        m_scalingFactorInt = ciphertext->m_scalingFactorInt;
-        encodingType       = ciphertext->encodingType;
-        m_slots            = ciphertext->m_slots;
-        m_metadataMap      = ciphertext->m_metadataMap;
-    }
+    explicit CiphertextImpl(const Ciphertext<Element>& ciphertext) : CiphertextImpl(*ciphertext) {}
 
     /**
    * Move constructor
+   *
+   * The CryptoObject base only offers a const&& overload, which ends up
+   * copying the context pointer and the key tag. We take both fields over
+   * directly instead, and every member is initialized in the init-list so
+   * that the default metadata map is never allocated just to be replaced.
+   * Moving a ciphertext therefore performs no heap allocation at all.
    */
-    CiphertextImpl(CiphertextImpl<Element>&& ciphertext) : CryptoObject<Element>(ciphertext) {
-        m_elements         = std::move(ciphertext.m_elements);
-        m_noiseScaleDeg    = std::move(ciphertext.m_noiseScaleDeg);
-        m_level            = std::move(ciphertext.m_level);
-        m_hopslevel        = std::move(ciphertext.m_hopslevel);
-        m_scalingFactor    = std::move(ciphertext.m_scalingFactor);
-        m_scalingFactorInt = std::move(ciphertext.m_scalingFactorInt);
-        encodingType       = std::move(ciphertext.encodingType);
-        m_slots            = std::move(ciphertext.m_slots);
-        m_metadataMap      = std::move(ciphertext.m_metadataMap);
+    CiphertextImpl(CiphertextImpl<Element>&& ciphertext) noexcept
+        : CryptoObject<Element>(),
+          m_elements(std::move(ciphertext.m_elements)),
+          m_noiseScaleDeg(ciphertext.m_noiseScaleDeg),
+          encodingType(ciphertext.encodingType),
+          m_scalingFactor(ciphertext.m_scalingFactor),
+          m_scalingFactorInt(std::move(ciphertext.m_scalingFactorInt)),
+          m_level(ciphertext.m_level),
+          m_hopslevel(ciphertext.m_hopslevel),
+          m_slots(ciphertext.m_slots),
+          m_metadataMap(std::move(ciphertext.m_metadataMap)) {
+        this->context.swap(ciphertext.context);
+        this->keyTag.swap(ciphertext.keyTag);
     }
 
-    explicit CiphertextImpl(Ciphertext<Element>&& ciphertext) : CryptoObject<Element>(*ciphertext) {
-        m_elements         = std::move(ciphertext->m_elements);
-        m_noiseScaleDeg    = std::move(ciphertext->m_noiseScaleDeg);
-        m_level            = std::move(ciphertext->m_level);
-        m_hopslevel        = std::move(ciphertext->m_hopslevel);
-        m_scalingFactor    = std::move(ciphertext->m_scalingFactor);
-        m_scalingFactorInt = std::move(ciphertext->m_scalingFactorInt);
-        encodingType       = std::move(ciphertext->encodingType);
-        m_slots            = std::move(ciphertext->m_slots);
-        m_metadataMap      = std::move(ciphertext->m_metadataMap);
-    }
+    /**
+   * Moves the contents out of the object owned by the given pointer.
+   * The pointer itself keeps the (now empty) object alive.
+   */
+    explicit CiphertextImpl(Ciphertext<Element>&& ciphertext) noexcept : CiphertextImpl(std::move(*ciphertext)) {}
 
     /**
    * This method creates a copy of this, skipping the actual encrypted
@@ -142,10 +140,12 @@ public:
    * and metadata.
    */
     virtual Ciphertext<Element> CloneEmpty() const {
-        Ciphertext<Element> ct(std::make_shared<CiphertextImpl<Element>>(this->GetCryptoContext(), this->GetKeyTag(),
-                                                                         this->GetEncodingType()));
+        // The shell comes from the thread's CiphertextPool, so the object, its
+        // shared_ptr control block and its metadata map are reused when possible
+        // (the ring elements are not: every result gets new ones)
+        Ciphertext<Element> ct(
+            CiphertextPool<Element>::Acquire(this->GetCryptoContext(), this->GetKeyTag(), this->GetEncodingType()));
 
-        ct->m_metadataMap    = std::make_shared<std::map<std::string, std::shared_ptr<Metadata>>>();
         *(ct->m_metadataMap) = *(this->m_metadataMap);
 
         return ct;
@@ -203,17 +203,19 @@ public:
    * @param &rhs the CiphertextImpl to move from
    * @return this CiphertextImpl
    */
-    CiphertextImpl<Element>& operator=(CiphertextImpl<Element>&& rhs) {
+    CiphertextImpl<Element>& operator=(CiphertextImpl<Element>&& rhs) noexcept {
         if (this != &rhs) {
-            CryptoObject<Element>::operator=(rhs);
+            // CryptoObject<Element>::operator=(rhs) would copy the key tag
+            this->context            = std::move(rhs.context);
+            this->keyTag             = std::move(rhs.keyTag);
             this->m_elements         = std::move(rhs.m_elements);
-            this->m_noiseScaleDeg    = std::move(rhs.m_noiseScaleDeg);
-            this->m_level            = std::move(rhs.m_level);
-            this->m_hopslevel        = std::move(rhs.m_hopslevel);
-            this->m_scalingFactor    = std::move(rhs.m_scalingFactor);
+            this->m_noiseScaleDeg    = rhs.m_noiseScaleDeg;
+            this->m_level            = rhs.m_level;
+            this->m_hopslevel        = rhs.m_hopslevel;
+            this->m_scalingFactor    = rhs.m_scalingFactor;
             this->m_scalingFactorInt = std::move(rhs.m_scalingFactorInt);
-            this->encodingType       = std::move(rhs.encodingType);
-            this->m_slots            = std::move(rhs.m_slots);
+            this->encodingType       = rhs.encodingType;
+            this->m_slots            = rhs.m_slots;
             this->m_metadataMap      = std::move(rhs.m_metadataMap);
         }
 
@@ -584,6 +586,43 @@ public:
     }
 
 private:
+    friend class CiphertextPool<Element>;
+
+    /**
+   * Puts a recycled shell back into the state of a freshly constructed
+   * CiphertextImpl(cc, id, encType). The metadata map is cleared in place
+   * when nobody else shares it.
+   */
+    void Reset(CryptoContext<Element> cc, const std::string& id, PlaintextEncodings encType) {
+        this->context = std::move(cc);
+        this->keyTag  = id;
+        m_elements.clear();
+        m_noiseScaleDeg    = 1;
+        encodingType       = encType;
+        m_scalingFactor    = 1;
+        m_scalingFactorInt = 1;
+        m_level            = 0;
+        m_hopslevel        = 0;
+        m_slots            = 0;
+        if (m_metadataMap && m_metadataMap.use_count() == 1)
+            m_metadataMap->clear();
+        else
+            m_metadataMap = std::make_shared<std::map<std::string, std::shared_ptr<Metadata>>>();
+    }
+
+    /**
+   * Drops everything that can keep other objects alive while the shell sits
+   * in the pool (the context, the key tag and the ring elements). The
+   * DCRTPoly buffers are freed here; the evaluation routines replace the
+   * whole element vector through SetElements(), so keeping them would only
+   * hold memory without being reused.
+   */
+    void Release() {
+        this->context.reset();
+        this->keyTag.clear();
+        m_elements.clear();
+    }
+
     // vector of ring elements for this Ciphertext
     std::vector<Element> m_elements;
 
@@ -607,6 +646,213 @@ private:
     MetadataMap m_metadataMap = std::make_shared<std::map<std::string, std::shared_ptr<Metadata>>>();
 };
 
+/**
+ * @brief CiphertextPool
+ *
+ * Per-thread recycling pool for CiphertextImpl shells. CloneEmpty() (and
+ * therefore CloneZero()/Clone(), which the evaluation routines use to create
+ * their results) hands out shells from this pool instead of calling
+ * std::make_shared. When the last Ciphertext referencing a shell is released,
+ * the custom deleter frees its ring elements and returns the object to the
+ * pool of the releasing thread. The shared_ptr control blocks are recycled
+ * through ControlBlockAllocator in the same way. What is saved per result is
+ * therefore the CiphertextImpl allocation, its control block and its metadata
+ * map; the DCRTPoly buffers are allocated and freed as before.
+ *
+ * Each thread keeps at most GetMaxSize() idle shells and control blocks.
+ * SetMaxSize() trims the calling thread's lists at once; every other thread
+ * trims its own on its next Acquire() or release. SetMaxSize(0) therefore
+ * disables pooling on all threads and restores plain new/delete behavior.
+ *
+ * @tparam Element a ring element.
+ */
+template <class Element>
+class CiphertextPool {
+public:
+    /**
+   * Returns a ciphertext shell as if constructed by
+   * CiphertextImpl(cc, id, encType), reusing a pooled one if available.
+   */
+    static Ciphertext<Element> Acquire(CryptoContext<Element> cc, const std::string& id = "",
+                                       PlaintextEncodings encType = INVALID_ENCODING) {
+        FreeList& list = GetFreeList();
+        Trim(list);
+        CiphertextImpl<Element>* ct;
+        if (!list.shells.empty()) {
+            ct = list.shells.back();
+            list.shells.pop_back();
+            ct->Reset(std::move(cc), id, encType);
+            list.hits++;
+        }
+        else {
+            ct = new CiphertextImpl<Element>(std::move(cc), id, encType);
+            list.misses++;
+        }
+        return Ciphertext<Element>(ct, Deleter(), ControlBlockAllocator<CiphertextImpl<Element>>());
+    }
+
+    /**
+   * Maximum number of idle shells kept per thread
+   */
+    static size_t GetMaxSize() {
+        return MaxSize();
+    }
+
+    static void SetMaxSize(size_t maxSize) {
+        MaxSize() = maxSize;
+        Trim(GetFreeList());
+    }
+
+    /**
+   * Number of idle shells currently pooled by the calling thread
+   */
+    static size_t Size() {
+        return GetFreeList().shells.size();
+    }
+
+    /**
+   * Number of Acquire() calls on the calling thread served from the pool
+   * (hits) and by a fresh allocation (misses)
+   */
+    static size_t Hits() {
+        return GetFreeList().hits;
+    }
+
+    static size_t Misses() {
+        return GetFreeList().misses;
+    }
+
+    /**
+   * shared_ptr deleter: recycles the shell instead of destroying it
+   */
+    struct Deleter {
+        void operator()(CiphertextImpl<Element>* ct) const {
+            if (!Alive()) {
+                delete ct;
+                return;
+            }
+            FreeList& list = GetFreeList();
+            Trim(list);
+            if (list.shells.size() >= MaxSize()) {
+                delete ct;
+                return;
+            }
+            ct->Release();
+            list.shells.push_back(ct);
+        }
+    };
+
+    /**
+   * shared_ptr allocator: keeps the freed control blocks on a per-thread list
+   */
+    template <class T>
+    struct ControlBlockAllocator {
+        using value_type = T;
+
+        ControlBlockAllocator() = default;
+        template <class U>
+        ControlBlockAllocator(const ControlBlockAllocator<U>&) {}
+
+        T* allocate(std::size_t n) {
+            if (n == 1 && BlocksAlive())
+                TrimBlocks();
+            if (n == 1 && BlocksAlive() && !Blocks().empty()) {
+                void* p = Blocks().back();
+                Blocks().pop_back();
+                return static_cast<T*>(p);
+            }
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+
+        void deallocate(T* p, std::size_t n) {
+            if (n == 1 && BlocksAlive())
+                TrimBlocks();
+            if (n == 1 && BlocksAlive() && Blocks().size() < MaxSize()) {
+                Blocks().push_back(p);
+                return;
+            }
+            ::operator delete(p);
+        }
+
+        template <class U>
+        bool operator==(const ControlBlockAllocator<U>&) const {
+            return true;
+        }
+        template <class U>
+        bool operator!=(const ControlBlockAllocator<U>&) const {
+            return false;
+        }
+
+    private:
+        struct BlockList : std::vector<void*> {
+            ~BlockList() {
+                BlocksAlive() = false;
+                for (void* p : *this)
+                    ::operator delete(p);
+            }
+        };
+
+        // a list filled under a larger MaxSize() shrinks on the next call
+        static void TrimBlocks() {
+            while (Blocks().size() > MaxSize()) {
+                ::operator delete(Blocks().back());
+                Blocks().pop_back();
+            }
+        }
+
+        static BlockList& Blocks() {
+            thread_local BlockList blocks;
+            return blocks;
+        }
+
+        // the thread_local destruction order between BlockList and FreeList is
+        // unspecified, so the block list has its own flag
+        static bool& BlocksAlive() {
+            thread_local bool alive = true;
+            return alive;
+        }
+    };
+
+private:
+    struct FreeList {
+        std::vector<CiphertextImpl<Element>*> shells;
+        size_t hits   = 0;
+        size_t misses = 0;
+
+        ~FreeList() {
+            Alive() = false;
+            for (auto ct : shells)
+                delete ct;
+        }
+    };
+
+    // drops the shells above MaxSize(), which another thread may have lowered
+    static void Trim(FreeList& list) {
+        while (list.shells.size() > MaxSize()) {
+            delete list.shells.back();
+            list.shells.pop_back();
+        }
+    }
+
+    static FreeList& GetFreeList() {
+        thread_local FreeList list;
+        return list;
+    }
+
+    // false once the calling thread's pool has been destroyed (thread exit);
+    // later releases then fall back to plain delete
+    static bool& Alive() {
+        thread_local bool alive = true;
+        return alive;
+    }
+
+    // shared by all threads; pool workers read it while another thread may set it
+    static std::atomic<size_t>& MaxSize() {
+        static std::atomic<size_t> maxSize{64};
+        return maxSize;
+    }
+};
+
 // TODO the op= are not doing the work in-place, and should be updated
 
 /**
@@ -0,0 +1,176 @@
+/*
+  Micro-benchmarks: ciphertext handoff cost through a 10-stage pipeline,
+  and CloneEmpty() with and without the CiphertextPool
+
+  ciphertext.h 의 move constructor / move assignment 수정 확인용.
+  Build against OpenFHE with week5/ciphertext.h in place of
+  src/pke/include/ciphertext.h.
+ */
+
+#define PROFILE
+
+#include "openfhe.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace lbcrypto;
+
+// Global allocation counter, so that we can check a move really allocates nothing
+static std::atomic<size_t> g_allocations{0};
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+constexpr size_t NUM_STAGES = 10;
+constexpr size_t NUM_ROUNDS = 10000;
+
+// One pipeline stage: takes ownership of its input and hands it to the next stage
+CiphertextImpl<DCRTPoly> MoveStage(CiphertextImpl<DCRTPoly>&& in) {
+    CiphertextImpl<DCRTPoly> out(std::move(in));
+    return out;
+}
+
+CiphertextImpl<DCRTPoly> CopyStage(const CiphertextImpl<DCRTPoly>& in) {
+    CiphertextImpl<DCRTPoly> out(in);
+    return out;
+}
+
+void MovePipelineBenchmark();
+void CiphertextPoolBenchmark();
+
+int main(int argc, char* argv[]) {
+    MovePipelineBenchmark();
+
+    CiphertextPoolBenchmark();
+
+    return 0;
+}
+
+void MovePipelineBenchmark() {
+    std::cout << "\n\n\n ===== MovePipelineBenchmark ============= " << std::endl;
+
+    uint32_t batchSize = 8;
+    CCParams<CryptoContextCKKSRNS> parameters;
+    parameters.SetMultiplicativeDepth(2);
+    parameters.SetScalingModSize(50);
+    parameters.SetBatchSize(batchSize);
+
+    CryptoContext<DCRTPoly> cc = GenCryptoContext(parameters);
+
+    std::cout << "CKKS scheme is using ring dimension " << cc->GetRingDimension() << std::endl << std::endl;
+
+    cc->Enable(PKE);
+    cc->Enable(KEYSWITCH);
+    cc->Enable(LEVELEDSHE);
+
+    auto keys = cc->KeyGen();
+
+    std::vector<double> x = {1.0, 1.01, 1.02, 1.03, 1.04, 1.05, 1.06, 1.07};
+    Plaintext ptxt        = cc->MakeCKKSPackedPlaintext(x);
+    auto c                = cc->Encrypt(keys.publicKey, ptxt);
+
+    // Moves: the same object travels through every stage
+    CiphertextImpl<DCRTPoly> ct(*c);
+
+    TimeVar t;
+    size_t allocBefore = g_allocations.load();
+    TIC(t);
+    for (size_t r = 0; r < NUM_ROUNDS; r++) {
+        for (size_t s = 0; s < NUM_STAGES; s++) {
+            ct = MoveStage(std::move(ct));
+        }
+    }
+    double timeMove   = TOC_NS(t);
+    size_t allocsMove = g_allocations.load() - allocBefore;
+
+    // Copies: what every stage paid before the move constructor was fixed, at worst
+    allocBefore = g_allocations.load();
+    TIC(t);
+    for (size_t r = 0; r < NUM_ROUNDS; r++) {
+        for (size_t s = 0; s < NUM_STAGES; s++) {
+            ct = CopyStage(ct);
+        }
+    }
+    double timeCopy   = TOC_NS(t);
+    size_t allocsCopy = g_allocations.load() - allocBefore;
+
+    // The moved-through ciphertext must still decrypt to the input
+    Plaintext result;
+    std::cout.precision(8);
+    cc->Decrypt(keys.secretKey, std::make_shared<CiphertextImpl<DCRTPoly>>(std::move(ct)), &result);
+    result->SetLength(batchSize);
+    std::cout << "Decrypted after " << NUM_ROUNDS * NUM_STAGES << " handoffs = " << result << std::endl;
+
+    double handoffs = static_cast<double>(NUM_ROUNDS * NUM_STAGES);
+    std::cout << " - " << NUM_STAGES << "-stage pipeline with moves: " << timeMove / handoffs << " ns/handoff, "
+              << allocsMove / handoffs << " allocations/handoff" << std::endl;
+    std::cout << " - " << NUM_STAGES << "-stage pipeline with copies: " << timeCopy / handoffs << " ns/handoff, "
+              << allocsCopy / handoffs << " allocations/handoff" << std::endl;
+}
+
+void CiphertextPoolBenchmark() {
+    std::cout << "\n\n\n ===== CiphertextPoolBenchmark ============= " << std::endl;
+
+    uint32_t batchSize = 8;
+    CCParams<CryptoContextCKKSRNS> parameters;
+    parameters.SetMultiplicativeDepth(2);
+    parameters.SetScalingModSize(50);
+    parameters.SetBatchSize(batchSize);
+
+    CryptoContext<DCRTPoly> cc = GenCryptoContext(parameters);
+
+    cc->Enable(PKE);
+    cc->Enable(KEYSWITCH);
+    cc->Enable(LEVELEDSHE);
+
+    auto keys = cc->KeyGen();
+    cc->EvalMultKeyGen(keys.secretKey);
+
+    std::vector<double> x = {1.0, 1.01, 1.02, 1.03, 1.04, 1.05, 1.06, 1.07};
+    Plaintext ptxt        = cc->MakeCKKSPackedPlaintext(x);
+    auto c                = cc->Encrypt(keys.publicKey, ptxt);
+
+    TimeVar t;
+    const size_t poolSize = CiphertextPool<DCRTPoly>::GetMaxSize();
+
+    // Result shells only: this is the part of every EvalAdd/EvalMult the pool removes
+    for (size_t maxSize : {size_t(0), poolSize}) {
+        CiphertextPool<DCRTPoly>::SetMaxSize(maxSize);
+
+        size_t allocBefore = g_allocations.load();
+        TIC(t);
+        for (size_t r = 0; r < NUM_ROUNDS; r++) {
+            auto ct = c->CloneEmpty();
+        }
+        double timeClone   = TOC_NS(t);
+        size_t allocsClone = g_allocations.load() - allocBefore;
+
+        // Whole operations, whose results are released right away
+        TIC(t);
+        for (size_t r = 0; r < NUM_ROUNDS / 10; r++) {
+            auto cAdd = cc->EvalAdd(c, c);
+        }
+        double timeAdd = TOC_US(t);
+
+        std::cout << (maxSize ? " - with pool:    " : " - without pool: ") << timeClone / NUM_ROUNDS
+                  << " ns/CloneEmpty, " << static_cast<double>(allocsClone) / NUM_ROUNDS << " allocations/CloneEmpty, "
+                  << timeAdd / (NUM_ROUNDS / 10) << " us/EvalAdd" << std::endl;
+    }
+
+    std::cout << " - pool hits: " << CiphertextPool<DCRTPoly>::Hits()
+              << ", misses: " << CiphertextPool<DCRTPoly>::Misses() << std::endl;
+}